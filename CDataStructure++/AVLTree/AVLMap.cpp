@@ -0,0 +1 @@
+#include <AVLMap.h>
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include <AVLMapNode.h>
+#include <AVLTree.h>
+#include <utility>
+
+/*
+ * Ordered key-value map on top of the AVLTree rebalancing.
+ * Values are constructed in place and can be updated in place, so they are never copied by the map and
+ * move-only values are supported. Returned node pointers stay valid until the key is removed.
+ */
+template <typename K, typename V>
+class AVLMap
+{
+public:
+	using Node = AVLMapNode<K, V>;
+	// typedef pair containing the node of the key and whether it was inserted
+	using _AVL_inserted_Pair = std::pair<Node *, bool>;
+
+public:
+	AVLMap() = default;
+
+	// Delete constructors which may cause headache and bugs
+	AVLMap(const AVLMap &) = delete;
+	AVLMap(AVLMap &&) = delete;
+
+	/*
+	 *	Constructs the value from args if the key does not exist yet, otherwise nothing happens
+	 *	(args are not moved from).
+	 */
+	template <typename... Args>
+	_AVL_inserted_Pair try_emplace(const K &key, Args &&...args)
+	{
+		return tree.emplaceNode(key, key, std::forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	_AVL_inserted_Pair try_emplace(K &&key, Args &&...args)
+	{
+		// key is only moved into the node after all comparisons are done
+		return tree.emplaceNode(key, std::move(key), std::forward<Args>(args)...);
+	}
+
+	/*
+	 *	Inserts the value if the key does not exist yet, otherwise assigns it to the existing value.
+	 */
+	template <typename M>
+	_AVL_inserted_Pair insert_or_assign(const K &key, M &&value)
+	{
+		auto nodeRef = tree.emplaceNode(key, key, std::forward<M>(value));
+		if (!nodeRef.second)
+		{
+			nodeRef.first->getValue() = std::forward<M>(value);
+		}
+		return nodeRef;
+	}
+
+	template <typename M>
+	_AVL_inserted_Pair insert_or_assign(K &&key, M &&value)
+	{
+		auto nodeRef = tree.emplaceNode(key, std::move(key), std::forward<M>(value));
+		if (!nodeRef.second)
+		{
+			nodeRef.first->getValue() = std::forward<M>(value);
+		}
+		return nodeRef;
+	}
+
+	/*
+	 *	Returns the value of key, a default constructed value is inserted if the key does not exist.
+	 */
+	V &operator[](const K &key)
+	{
+		return try_emplace(key).first->getValue();
+	}
+
+	V &operator[](K &&key)
+	{
+		return try_emplace(std::move(key)).first->getValue();
+	}
+
+	Node *searchNode(const K &key)
+	{
+		return tree.searchNode(key);
+	}
+
+	/*
+	 *	Remove the key and its value. Returns false if the key does not exist.
+	 */
+	bool removeNode(const K &key)
+	{
+		return tree.removeNode(key);
+	}
+
+	void printTree()
+	{
+		tree.printTree();
+	}
+
+private:
+	AVLTree<K, Node> tree;
+};
@@ -0,0 +1 @@
+#include <AVLMapNode.h>
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+#include <utility>
+
+/*
+ * Node of the AVLMap. Same interface as AVLNode so that it can be rebalanced by AVLTree, where getData()
+ * returns the key the tree is ordered by. The value is mutable and constructed in place.
+ */
+template <typename K, typename V>
+class AVLMapNode
+{
+public:
+	template <typename KeyArg, typename... ValueArgs>
+	explicit AVLMapNode(
+		AVLMapNode *parent,
+		KeyArg &&key,
+		ValueArgs &&...valueArgs)
+		: key(std::forward<KeyArg>(key)),
+		  value(std::forward<ValueArgs>(valueArgs)...),
+		  left(nullptr),
+		  right(nullptr),
+		  parent(parent),
+		  bf(0)
+	{
+	}
+
+	inline const K &getData() const
+	{
+		return key;
+	}
+
+	inline const K &getKey() const
+	{
+		return key;
+	}
+
+	inline V &getValue()
+	{
+		return value;
+	}
+
+	inline const V &getValue() const
+	{
+		return value;
+	}
+
+	inline const signed char getBf() const
+	{
+		return bf;
+	}
+
+	inline void setBf(const signed char newBf)
+	{
+		this->bf = newBf;
+	}
+
+	inline void setLeft(AVLMapNode *newLeft)
+	{
+		this->left = newLeft;
+	}
+
+	inline void setRight(AVLMapNode *newRight)
+	{
+		this->right = newRight;
+	}
+
+	inline void setParent(AVLMapNode *newParent)
+	{
+		this->parent = newParent;
+	}
+
+	inline bool hasLeft() const
+	{
+		return left != nullptr;
+	}
+
+	inline bool hasRight() const
+	{
+		return right != nullptr;
+	}
+
+	inline bool hasParent() const
+	{
+		return parent != nullptr;
+	}
+
+	inline AVLMapNode *getLeft()
+	{
+		return left;
+	}
+
+	inline AVLMapNode *getRight()
+	{
+		return right;
+	}
+
+	inline AVLMapNode *getParent()
+	{
+		return parent;
+	}
+
+private:
+	const K key;		// key the map is ordered by
+	V value;			// value mapped to the key
+	AVLMapNode *left;	// pointer to left node
+	AVLMapNode *right;	// pointer to right node
+	AVLMapNode *parent; // pointer to parent node
+	signed char bf;		// balance factor of current node
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <iostream>
+#include <utility>
 
 template <typename T>
 class AVLNode
@@ -12,7 +13,8 @@ public:
 		  left(nullptr),
 		  right(nullptr),
 		  parent(nullptr),
-		  bf(0) // each node inserted starts off with balance factor of 0 since it is a leaf node (no left or right trees available yet)
+		  bf(0), // each node inserted starts off with balance factor of 0 since it is a leaf node (no left or right trees available yet)
+		  dead(false)
 	{
 	}
 
@@ -22,11 +24,26 @@ public:
 		: data(data),
 		  parent(parent),
 		  bf(0),
+		  dead(false),
 		  left(nullptr),
 		  right(nullptr)
 	{
 	}
 
+	// constructs the data in place from args, so that data can be moved into the node instead of being copied
+	template <typename... Args>
+	explicit AVLNode(
+		AVLNode *parent,
+		Args &&...args)
+		: data(std::forward<Args>(args)...),
+		  left(nullptr),
+		  right(nullptr),
+		  parent(parent),
+		  bf(0),
+		  dead(false)
+	{
+	}
+
 	// ~AVLNode()
 	// {
 	// 	if (left)
@@ -62,6 +79,17 @@ public:
 		this->bf = newBf;
 	}
 
+	// a dead node is removed logically but still linked into the tree (see AVLTree::removeNodeLazy)
+	inline bool isDead() const
+	{
+		return dead;
+	}
+
+	inline void setDead(const bool newDead)
+	{
+		this->dead = newDead;
+	}
+
 	inline const T &getData() const
 	{
 		return data;
@@ -155,4 +183,5 @@ private:
 	AVLNode *right;	 // pointer to right node
 	AVLNode *parent; // pointer to parent node
 	signed char bf;	 // balance factor of current node
+	bool dead;		 // tombstone of lazy deletion, fits into the padding after bf
 };
\ No newline at end of file
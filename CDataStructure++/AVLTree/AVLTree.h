@@ -1,15 +1,62 @@
 #pragma once
 #include <AVLNode.h>
+#include <FrozenAVLTree.h>
+#include <TreeFile.h>
+#include <MemoryUsage.h>
+#include <TeardownQueue.h>
+#include <Trace.h>
+#include <algorithm>
 #include <cstddef>
+#include <future>
 #include <iostream>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+// AVL_STATS(statement) is only compiled in if the tree collects AVLTreeStats
+#if defined(AVL_TREE_STATS)
+#include <AVLTreeStats.h>
+#define AVL_STATS(...) __VA_ARGS__
+#else
+#define AVL_STATS(...)
+#endif
+
+// a node type with updateFromChildren() keeps a value computed from its subtree (see IntervalNode)
+template <typename Node, typename = void>
+struct isAugmentedAVLNode : std::false_type
+{
+};
+
+template <typename Node>
+struct isAugmentedAVLNode<Node, std::void_t<decltype(std::declval<Node &>().updateFromChildren())>> : std::true_type
+{
+};
 
-template <typename T>
+// a node type with isDead()/setDead() can be removed lazily (see AVLTree::removeNodeLazy)
+template <typename Node, typename = void>
+struct hasAVLTombstone : std::false_type
+{
+};
+
+template <typename Node>
+struct hasAVLTombstone<Node, std::void_t<decltype(std::declval<Node &>().isDead()), decltype(std::declval<Node &>().setDead(true))>> : std::true_type
+{
+};
+
+/*
+ * Node is the type of node the tree is built from. It defaults to AVLNode<T>, but any node type with the same
+ * interface can reuse the rebalancing of this tree (see AVLMapNode). The tree orders nodes by getData().
+ * If the node has updateFromChildren(), it is called bottom-up on every node whose subtree changed.
+ */
+template <typename T, typename Node = AVLNode<T>>
 class AVLTree
 {
 public:
 	// typedef pair containing the deleted root and whether it was deleted from the right direction
-	using _AVL_fromRight_Pair = std::pair<AVLNode<T> *, bool>;
+	using _AVL_fromRight_Pair = std::pair<Node *, bool>;
+	// typedef pair containing the found or inserted node and whether it was inserted
+	using _AVL_inserted_Pair = std::pair<Node *, bool>;
 
 public:
 	AVLTree()
@@ -18,20 +65,53 @@ public:
 	}
 
 	AVLTree(const T &data)
-		: root(new AVLNode<T>(data))
+		: root(new Node(nullptr, data)),
+		  nodeCount(1)
 	{
 	}
 
 	// Delete constructors which may cause headache and bugs
-	AVLTree(const AVLTree<T> &) = delete;
-	AVLTree(AVLTree<T> &&) = delete;
+	AVLTree(const AVLTree &) = delete;
+	AVLTree(AVLTree &&) = delete;
 
 	~AVLTree()
 	{
 		cleanUpTree(root);
 	}
 
-	void printTree(AVLNode<T> *node = nullptr)
+	/*
+	 *	Deletes all nodes, iteratively and in O(n).
+	 */
+	void clear()
+	{
+		TRACE_SCOPE("AVLTree::clear");
+		cleanUpTree(root);
+		root = nullptr;
+		nodeCount = 0;
+		deadCount = 0;
+		AVL_STATS(stats.nodeCount = 0;)
+	}
+
+	/*
+	 *	Detaches all nodes in O(1) and deletes them on the TeardownQueue thread, the tree is empty and usable right
+	 *	away. With parallel = true, the teardown splits the work into disjoint subtrees freed on separate threads.
+	 *	The returned future is ready once every node is freed, it can be dropped without waiting: the TeardownQueue
+	 *	finishes before the program exits.
+	 */
+	std::future<void> clearDeferred(const bool parallel = false)
+	{
+		Node *oldRoot = root;
+		root = nullptr;
+		nodeCount = 0;
+		deadCount = 0;
+		AVL_STATS(stats.nodeCount = 0;)
+
+		const size_t parallelDepth = parallel ? getParallelDepth() : 0;
+		return TeardownQueue::enqueue([oldRoot, parallelDepth]()
+									  { cleanUpTreeParallel(oldRoot, parallelDepth); });
+	}
+
+	void printTree(Node *node = nullptr)
 	{
 		std::cout << "Printing the AVL Tree\n";
 		std::cout << "|-- = left node (value < parent value)\n";
@@ -49,36 +129,392 @@ public:
 
 	/*
 	 *	Remove node with given data. Rebalance tree appropriately.
+	 *	Returns false if no node with the given data exists.
 	 */
-	void removeNode(const T &data)
+	bool removeNode(const T &data)
 	{
-		_AVL_fromRight_Pair retValue = removeNode(data, root);
+		Node *nodeToRemove = searchNode(data, root);
+		// a dead node is already removed, it stays until the next compaction
+		if (nodeToRemove == nullptr || isDeadNode(nodeToRemove))
+			return false;
+
+		_AVL_fromRight_Pair retValue = removeNode(nodeToRemove);
 		auto parentRemovedNodeRef = retValue.first;
 		auto isDeletedFromRightTree = retValue.second;
 
+		// the rotations while rebalancing expect correct values below the rotated nodes
+		updatePathToRoot(parentRemovedNodeRef);
+
+		AVL_STATS(walkLength = 0;)
 		if (parentRemovedNodeRef)
 			rebalanceTreeDeletion(parentRemovedNodeRef, isDeletedFromRightTree);
+		AVL_STATS(AVLTreeStats::record(stats.deletionWalkLengths, walkLength); --stats.nodeCount;)
+		--nodeCount;
+
+		return true;
+	}
+
+	/*
+	 *	Lazy deletion: marks the node with given data as dead in O(log n) instead of unlinking it, no rotations are
+	 *	done. Dead nodes are not found anymore and are revived if their data is inserted again. Once more than
+	 *	the compaction threshold of all nodes are dead, the tree is rebuilt from the live nodes (see compact).
+	 *	Returns false if no live node with the given data exists. Needs a node type with a tombstone (AVLNode).
+	 */
+	bool removeNodeLazy(const T &data)
+	{
+		static_assert(HAS_TOMBSTONE, "lazy deletion needs a node type with isDead()/setDead()");
+
+		Node *nodeToRemove = searchNode(data, root);
+		if (nodeToRemove == nullptr || nodeToRemove->isDead())
+			return false;
+
+		nodeToRemove->setDead(true);
+		++deadCount;
+		if (static_cast<double>(deadCount) > compactionThreshold * static_cast<double>(nodeCount))
+		{
+			compact();
+		}
+		return true;
+	}
+
+	/*
+	 *	Deletes all dead nodes and links the live nodes as perfectly balanced tree in O(n).
+	 *	The live nodes are reused, so pointers to them stay valid.
+	 */
+	void compact()
+	{
+		TRACE_SCOPE("AVLTree::compact");
+		if (deadCount == 0)
+			return;
+
+		std::vector<Node *> liveNodes;
+		liveNodes.reserve(nodeCount - deadCount);
+		collectLiveNodes(root, liveNodes);
+
+		Node *newRoot = nullptr;
+		linkBalanced(liveNodes.data(), liveNodes.data() + liveNodes.size(), nullptr, newRoot);
+		root = newRoot;
+		nodeCount = liveNodes.size();
+		deadCount = 0;
+		AVL_STATS(stats.nodeCount = nodeCount;)
+	}
+
+	/*
+	 *	Fraction of dead nodes (of all nodes in the tree) at which removeNodeLazy compacts the tree.
+	 */
+	void setCompactionThreshold(const double fraction)
+	{
+		compactionThreshold = fraction;
+	}
+
+	// amount of nodes removed with removeNodeLazy that are still in the tree
+	size_t getDeadCount() const
+	{
+		return deadCount;
+	}
+
+	// amount of live data in the tree
+	size_t getSize() const
+	{
+		return nodeCount - deadCount;
+	}
+
+	/*
+	 *	Heap memory of the nodes, one allocation per node. Dead nodes of removeNodeLazy still hold their memory
+	 *	until compact, so they count for the bytes but not for the elements. Memory that T itself allocates isn't
+	 *	included.
+	 */
+	MemoryUsage memoryUsage() const
+	{
+		MemoryUsage usage;
+		usage.allocations = nodeCount;
+		usage.bytesLive = nodeCount * sizeof(Node);
+		usage.elements = getSize();
+		return usage;
 	}
 
 	void insertNode(const T &data)
 	{
-		const auto insertedNodeRef = insertNode(data, root);
+		emplaceNode(data, data);
+	}
+
+	void insertNode(T &&data)
+	{
+		// data is only moved into the node after all comparisons are done
+		emplaceNode(data, std::move(data));
+	}
+
+	/*
+	 *	Returns the node with given data. If it does not exist yet, a node is constructed in place
+	 *	from args (Node(parent, args...)) and the tree is rebalanced. The bool is true if the node was inserted.
+	 */
+	template <typename... Args>
+	_AVL_inserted_Pair emplaceNode(const T &data, Args &&...args)
+	{
+		return emplaceNodeFrom(root, data, std::forward<Args>(args)...);
+	}
+
+	/*
+	 *	Insert given data, starting the search at hint (a node returned before) instead of the root.
+	 *	Returns the node with the data, which can be the hint of the next insertion. See searchFrom.
+	 */
+	Node *insertNode(Node *hint, const T &data)
+	{
+		if (hint == nullptr)
+			return emplaceNode(data, data).first;
+
+		return emplaceNodeFrom(climbFromFinger(hint, data), data, data).first;
+	}
+
+	/*
+	 *	Finger search: returns the node with given data like searchNode, but starts at finger (a node returned
+	 *	before) and only climbs up the parent links until the subtree can contain data. For data d positions
+	 *	away from the finger this visits O(log d) nodes instead of O(log n), e.g. for nearly sorted access.
+	 */
+	Node *searchFrom(Node *finger, const T &data)
+	{
+		if (finger == nullptr)
+			return searchNode(data);
 
-		if (insertedNodeRef)
-			rebalanceTreeInsertion(insertedNodeRef);
+		Node *foundNode = searchNode(data, climbFromFinger(finger, data));
+		return isDeadNode(foundNode) ? nullptr : foundNode;
 	}
 
-	AVLNode<T> *getRoot()
+	/*
+	 *	Inserts all elements of batch at once and returns how many were inserted (duplicates are skipped).
+	 *	The batch is sorted and split at every existing node on the way down. Elements that end up at the same
+	 *	empty position become a perfectly balanced subtree, and on the way back up every touched node joins its
+	 *	new left and right subtree with a single rebalancing walk instead of one walk per inserted element.
+	 *	With parallel = true, large parts of the batch are inserted into disjoint subtrees on separate threads.
+	 */
+	size_t insertBatch(std::vector<T> batch, const bool parallel = false)
+	{
+		TRACE_SCOPE("AVLTree::insertBatch");
+		std::sort(batch.begin(), batch.end());
+		batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+		if (batch.empty())
+			return 0;
+
+		size_t parallelDepth = 0;
+		if (parallel)
+		{
+			// spawn a thread on each level until every hardware thread has a part of the batch
+			for (size_t threads = 1; threads < std::thread::hardware_concurrency(); threads *= 2)
+				++parallelDepth;
+		}
+		// the counters are not synchronized, so batches are not split across threads while counting
+		AVL_STATS(parallelDepth = 0;)
+
+		// the subtrees are detached while inserting, so that no rotation sees the old root
+		Node *oldRoot = root;
+		root = nullptr;
+		const BatchResult result = insertBatch(oldRoot, batch.data(), batch.data() + batch.size(), parallelDepth);
+		root = result.root;
+		AVL_STATS(stats.nodeCount += result.inserted - result.revived;)
+		nodeCount += result.inserted - result.revived;
+		deadCount -= result.revived;
+		return result.inserted;
+	}
+
+	Node *getRoot()
 	{
 		return this->root;
 	}
 
-	AVLNode<T> *searchNode(const T &data)
+	/*
+	 *	Visitor traversals: visitor(data) is called for every live node in the given order. They follow the parent
+	 *	links instead of recursing, so there is no heap use and O(1) stack, and the tree is only read. The visitor
+	 *	must not change the tree.
+	 */
+	template <typename Visitor>
+	void forEachInOrder(Visitor &&visitor)
 	{
-		return searchNode(data, root);
+		for (Node *currNode = root != nullptr ? findLeftmostNode(root) : nullptr; currNode != nullptr;)
+		{
+			if (!isDeadNode(currNode))
+				visitor(currNode->getData());
+
+			if (currNode->hasRight())
+			{
+				currNode = findLeftmostNode(currNode->getRight());
+				continue;
+			}
+			// climb out of every subtree that is done, i.e. as long as currNode is a right child
+			Node *parentNode = currNode->getParent();
+			while (parentNode != nullptr && isRightChild(parentNode, currNode))
+			{
+				currNode = parentNode;
+				parentNode = parentNode->getParent();
+			}
+			currNode = parentNode;
+		}
 	}
 
-	inline AVLNode<T> *findInorderSuccessor(AVLNode<T> *rightNodeOfCurrNode)
+	template <typename Visitor>
+	void forEachPreOrder(Visitor &&visitor)
+	{
+		for (Node *currNode = root; currNode != nullptr;)
+		{
+			if (!isDeadNode(currNode))
+				visitor(currNode->getData());
+
+			if (currNode->hasLeft())
+			{
+				currNode = currNode->getLeft();
+				continue;
+			}
+			if (currNode->hasRight())
+			{
+				currNode = currNode->getRight();
+				continue;
+			}
+			// climb to the first ancestor whose right subtree is still open
+			Node *parentNode = currNode->getParent();
+			while (parentNode != nullptr && (isRightChild(parentNode, currNode) || !parentNode->hasRight()))
+			{
+				currNode = parentNode;
+				parentNode = parentNode->getParent();
+			}
+			currNode = parentNode != nullptr ? parentNode->getRight() : nullptr;
+		}
+	}
+
+	template <typename Visitor>
+	void forEachPostOrder(Visitor &&visitor)
+	{
+		for (Node *currNode = root != nullptr ? findFirstPostOrderNode(root) : nullptr; currNode != nullptr;)
+		{
+			Node *parentNode = currNode->getParent();
+			if (!isDeadNode(currNode))
+				visitor(currNode->getData());
+
+			// after a left child comes the right subtree of its parent, after a right child the parent itself
+			if (parentNode != nullptr && !isRightChild(parentNode, currNode) && parentNode->hasRight())
+				currNode = findFirstPostOrderNode(parentNode->getRight());
+			else
+				currNode = parentNode;
+		}
+	}
+
+	/*
+	 *	Map-reduce over all live data: returns identity combined in-order with map(data) of every node via reduce.
+	 *	reduce has to be associative with identity as neutral element, it need not be commutative. The top levels of
+	 *	the tree are split into disjoint subtrees which are reduced on separate threads, so map and reduce have to be
+	 *	safe to call concurrently. The tree must not change while it runs.
+	 */
+	template <typename Result, typename Map, typename Reduce>
+	Result parallelReduce(const Result &identity, Map &&map, Reduce &&reduce)
+	{
+		TRACE_SCOPE("AVLTree::parallelReduce");
+		return reduceSubtree(root, identity, map, reduce, getParallelDepth());
+	}
+
+	/*
+	 *	Calls visitor(data) for every live node, on several threads and in no particular order. The visitor has to be
+	 *	safe to call concurrently and must not change the tree.
+	 */
+	template <typename Visitor>
+	void parallelForEach(Visitor &&visitor)
+	{
+		TRACE_SCOPE("AVLTree::parallelForEach");
+		forEachSubtree(root, visitor, getParallelDepth());
+	}
+
+	Node *searchNode(const T &data)
+	{
+		AVL_STATS(searchDepth = 0;)
+		Node *foundNode = searchNode(data, root);
+		AVL_STATS(AVLTreeStats::record(stats.searchDepths, searchDepth);)
+		return isDeadNode(foundNode) ? nullptr : foundNode;
+	}
+
+#if defined(AVL_TREE_STATS)
+	AVLTreeStats getStats()
+	{
+		AVLTreeStats currStats = stats;
+		currStats.height = subtreeHeight(root);
+		return currStats;
+	}
+
+	void resetStats()
+	{
+		const size_t statsNodeCount = stats.nodeCount;
+		stats = AVLTreeStats();
+		stats.nodeCount = statsNodeCount;
+	}
+#endif
+
+	/*
+	 *	Copies the data into an immutable, contiguous search structure for read-only phases.
+	 *	The tree itself stays unchanged.
+	 */
+	FrozenAVLTree<T> freeze()
+	{
+		TRACE_SCOPE("AVLTree::freeze");
+		std::vector<const T *> sortedData;
+		collectInorder(root, sortedData);
+		return FrozenAVLTree<T>(sortedData);
+	}
+
+	/*
+	 *	Writes the tree including the balance factors in the TreeFile format, which can be loaded again by
+	 *	deserialize or searched in place by MappedTree. T has to be trivially copyable.
+	 */
+	bool serialize(std::ostream &out)
+	{
+		TRACE_SCOPE("AVLTree::serialize");
+		// the file has no tombstones
+		compact();
+		return writeTreeFile<T>(out, root, TreeFileHeader::HAS_BALANCE_FACTORS, [](Node *node)
+								{ return node->getBf(); });
+	}
+
+	/*
+	 *	Replaces the tree by the tree written by serialize in O(n). The nodes are linked as they were written,
+	 *	nothing is rebalanced. Returns false and keeps the tree if in holds no AVL tree of T: the records are
+	 *	checked for a single tree, ordered data and balance factors that match the subtree heights.
+	 */
+	bool deserialize(std::istream &in)
+	{
+		TRACE_SCOPE("AVLTree::deserialize");
+		std::vector<TreeFileNode<T>> records;
+		if (!readTreeFile(in, records, TreeFileHeader::HAS_BALANCE_FACTORS))
+			return false;
+
+		std::vector<Node *> nodes(records.size());
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			nodes[i] = new Node(nullptr, records[i].data);
+			nodes[i]->setBf(records[i].bf);
+		}
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			if (records[i].hasLeft())
+			{
+				nodes[i]->setLeft(nodes[i + 1]);
+				nodes[i + 1]->setParent(nodes[i]);
+			}
+			if (records[i].hasRight())
+			{
+				nodes[i]->setRight(nodes[records[i].right]);
+				nodes[records[i].right]->setParent(nodes[i]);
+			}
+		}
+		// children are stored behind their parents, so going backwards updates the subtree values bottom-up
+		for (size_t i = nodes.size(); i-- > 0;)
+		{
+			updateSubtree(nodes[i]);
+		}
+
+		cleanUpTree(root);
+		root = nodes.empty() ? nullptr : nodes.front();
+		nodeCount = nodes.size();
+		deadCount = 0;
+		AVL_STATS(stats.nodeCount = nodes.size();)
+		return true;
+	}
+
+	inline Node *findInorderSuccessor(Node *rightNodeOfCurrNode)
 	{
 		if (rightNodeOfCurrNode != nullptr)
 		{
@@ -97,7 +533,7 @@ public:
 
 private:
 	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
-	void printTree(const std::string &prefix, AVLNode<T> *node, bool isLeft)
+	void printTree(const std::string &prefix, Node *node, bool isLeft)
 	{
 		if (node != nullptr)
 		{
@@ -114,10 +550,53 @@ private:
 		}
 	}
 
-	AVLNode<T> *searchNode(const T &data, AVLNode<T> *currRoot)
+	template <typename... Args>
+	_AVL_inserted_Pair emplaceNodeFrom(Node *startNode, const T &data, Args &&...args)
+	{
+		const auto insertedNodeRef = insertNode(data, startNode, std::forward<Args>(args)...);
+
+		if (insertedNodeRef.second)
+		{
+			updatePathToRoot(insertedNodeRef.first);
+			AVL_STATS(walkLength = 0;)
+			rebalanceTreeInsertion(insertedNodeRef.first);
+			AVL_STATS(AVLTreeStats::record(stats.insertionWalkLengths, walkLength); ++stats.nodeCount;)
+			++nodeCount;
+		}
+		else if (isDeadNode(insertedNodeRef.first))
+		{
+			reviveNode(insertedNodeRef.first);
+			--deadCount;
+			return std::make_pair(insertedNodeRef.first, true);
+		}
+
+		return insertedNodeRef;
+	}
+
+	// returns the lowest ancestor of finger (or finger itself) whose subtree is the place of data in the tree
+	Node *climbFromFinger(Node *currNode, const T &data)
+	{
+		const bool searchRight = currNode->getData() < data;
+		while (currNode->hasParent() && !(currNode->getData() == data))
+		{
+			Node *parentNode = currNode->getParent();
+			const bool isLeftChild = !isRightChild(parentNode, currNode);
+
+			// the subtree of a left child ends before its parent and the subtree of a right child starts after it,
+			// so stop once the parent is beyond data on the side we are searching
+			if (searchRight ? (isLeftChild && data < parentNode->getData()) : (!isLeftChild && parentNode->getData() < data))
+				break;
+
+			currNode = parentNode;
+		}
+		return currNode;
+	}
+
+	Node *searchNode(const T &data, Node *currRoot)
 	{
 		if (currRoot != nullptr)
 		{
+			AVL_STATS(++searchDepth;)
 			const auto currRootData = currRoot->getData();
 
 			if (currRootData == data)
@@ -139,7 +618,26 @@ private:
 		return nullptr;
 	}
 
-	inline bool isRightChild(AVLNode<T> *parentNode, AVLNode<T> *nodeToCheck)
+	static inline Node *findLeftmostNode(Node *currNode)
+	{
+		while (currNode->hasLeft())
+		{
+			currNode = currNode->getLeft();
+		}
+		return currNode;
+	}
+
+	// the deepest node reached by always going left if possible and right otherwise
+	static inline Node *findFirstPostOrderNode(Node *currNode)
+	{
+		while (currNode->hasLeft() || currNode->hasRight())
+		{
+			currNode = currNode->hasLeft() ? currNode->getLeft() : currNode->getRight();
+		}
+		return currNode;
+	}
+
+	inline bool isRightChild(Node *parentNode, Node *nodeToCheck)
 	{
 		if (parentNode->getRight() == nodeToCheck)
 		{
@@ -149,9 +647,9 @@ private:
 	}
 
 	inline void setChildFromParent(
-		AVLNode<T> *parentNode,
-		AVLNode<T> *childToSet,
-		AVLNode<T> *newRefToSetTo)
+		Node *parentNode,
+		Node *childToSet,
+		Node *newRefToSetTo)
 	{
 		if (parentNode != nullptr)
 		{
@@ -166,7 +664,7 @@ private:
 		}
 	}
 
-	void rebalanceTreeDeletion(AVLNode<T> *parentDeletedNode, bool rightIsDeleted)
+	void rebalanceTreeDeletion(Node *parentDeletedNode, bool rightIsDeleted)
 	{
 		if (rightIsDeleted)
 		{
@@ -180,9 +678,9 @@ private:
 		}
 	}
 
-	void rebalanceTreeInsertion(AVLNode<T> *insertedNode)
+	void rebalanceTreeInsertion(Node *insertedNode)
 	{
-		AVLNode<T> *parentCurrNode = insertedNode->getParent();
+		Node *parentCurrNode = insertedNode->getParent();
 
 		// if the root is inserted, then no updates are needed since the tree is already balanced.
 		if (parentCurrNode != nullptr)
@@ -204,10 +702,12 @@ private:
 	 * SIMPLE ROTATION - LEFT CASE:
 	 *	Z (currNode) is a left child of its parent X (parentNode) and BF(Z) <= 0
 	 */
-	AVLNode<T> *rotateLeft(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	Node *rotateLeft(Node *parentNode, Node *currNode)
 	{
+		TRACE_SCOPE("AVLTree::rotateLeft");
+		AVL_STATS(++stats.rotationsLeft;)
 		// currNode is by 2 higher than its sibling
-		AVLNode<T> *innerChild = currNode->getLeft(); // Left child of currNode
+		Node *innerChild = currNode->getLeft(); // Left child of currNode
 		parentNode->setRight(innerChild);
 
 		if (innerChild != nullptr)
@@ -239,6 +739,8 @@ private:
 			currNode->setBf(0);
 		}
 
+		updateSubtree(parentNode);
+		updateSubtree(currNode);
 		return currNode; // return new root of rotated subtree
 	}
 
@@ -246,10 +748,12 @@ private:
 	 * SIMPLE ROTATION - RIGHT CASE:
 	 *	Z (currNode) is a right child of its parent X (parentNode) and BF(Z) >= 0
 	 */
-	AVLNode<T> *rotateRight(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	Node *rotateRight(Node *parentNode, Node *currNode)
 	{
+		TRACE_SCOPE("AVLTree::rotateRight");
+		AVL_STATS(++stats.rotationsRight;)
 		// currNode is by 2 higher than its sibling
-		AVLNode<T> *innerChild = currNode->getRight(); // Right child of currNode
+		Node *innerChild = currNode->getRight(); // Right child of currNode
 		parentNode->setLeft(innerChild);
 
 		if (innerChild != nullptr)
@@ -281,6 +785,8 @@ private:
 			currNode->setBf(0);
 		}
 
+		updateSubtree(parentNode);
+		updateSubtree(currNode);
 		return currNode; // return new root of rotated subtree
 	}
 
@@ -288,11 +794,13 @@ private:
 	 * DOUBLE ROTATION - RIGHT_LEFT ROTATION:
 	 *	Z (currNode) is a right child of its parent X (parentNode) and BF(Z) < 0
 	 */
-	AVLNode<T> *rotateRightLeft(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	Node *rotateRightLeft(Node *parentNode, Node *currNode)
 	{
-		AVLNode<T> *innerChild = currNode->getLeft();			// Y
-		AVLNode<T> *leftOfInnerChild = innerChild->getLeft();	// t2
-		AVLNode<T> *rightOfInnerChild = innerChild->getRight(); // t3
+		TRACE_SCOPE("AVLTree::rotateRightLeft");
+		AVL_STATS(++stats.rotationsRightLeft;)
+		Node *innerChild = currNode->getLeft();			// Y
+		Node *leftOfInnerChild = innerChild->getLeft();	// t2
+		Node *rightOfInnerChild = innerChild->getRight(); // t3
 		const auto innerChildBF = innerChild->getBf();
 
 		// if (innerChild != nullptr) // FOR DEBUGGING: it is assumed/expected that this node exists
@@ -346,6 +854,9 @@ private:
 
 		innerChild->setBf(0);
 
+		updateSubtree(parentNode);
+		updateSubtree(currNode);
+		updateSubtree(innerChild);
 		return innerChild;
 		// }
 		// std::cout << "[rotateRightLeft] innerChild is not valid (nullptr): " << innerChild << "\n";
@@ -356,11 +867,13 @@ private:
 	 * DOUBLE ROTATION - LEFT_RIGHT ROTATION:
 	 *	Z (currNode) is a left child of its parent X (parentNode) and BF(Z) > 0
 	 */
-	AVLNode<T> *rotateLeftRight(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	Node *rotateLeftRight(Node *parentNode, Node *currNode)
 	{
-		AVLNode<T> *innerChild = currNode->getRight();			// Y
-		AVLNode<T> *leftOfInnerChild = innerChild->getLeft();	// t3
-		AVLNode<T> *rightOfInnerChild = innerChild->getRight(); // t2
+		TRACE_SCOPE("AVLTree::rotateLeftRight");
+		AVL_STATS(++stats.rotationsLeftRight;)
+		Node *innerChild = currNode->getRight();			// Y
+		Node *leftOfInnerChild = innerChild->getLeft();	// t3
+		Node *rightOfInnerChild = innerChild->getRight(); // t2
 		const auto innerChildBF = innerChild->getBf();
 
 		// if (innerChild != nullptr) // FOR DEBUGGING: it is assumed/expected that this node exists
@@ -414,6 +927,9 @@ private:
 
 		innerChild->setBf(0);
 
+		updateSubtree(parentNode);
+		updateSubtree(currNode);
+		updateSubtree(innerChild);
 		return innerChild;
 		// }
 		// std::cout << "[rotateLeftRight] innerChild is not valid (nullptr): " << innerChild << "\n";
@@ -421,10 +937,11 @@ private:
 	}
 
 	inline void rebalanceTreeInsertion(
-		AVLNode<T> *parentNode,
-		AVLNode<T> *currNode,
+		Node *parentNode,
+		Node *currNode,
 		const signed char bfDiff)
 	{
+		AVL_STATS(++walkLength;)
 		// increment/decrement bf value of parent node
 		parentNode->setBf(parentNode->getBf() + bfDiff);
 
@@ -447,53 +964,41 @@ private:
 			//	Right Left	- X is rebalanced with a double	rotation rotate_RightLeft
 			//	Left Right	- X is rebalanced with a double	rotation rotate_LeftRight
 
+			Node *rotatedNode = nullptr;
 			if (parentNode->getRight() == currNode && currNode->getBf() >= 0) // Right Right	- Z is a right	child of its parent X and BF(Z) >= 0
 			{
-				if (parentNode == root)
-				{
-					root = rotateLeft(parentNode, currNode);
-				}
-				else
-				{
-					rotateLeft(parentNode, currNode);
-				}
+				rotatedNode = rotateLeft(parentNode, currNode);
 			}
 			else if (parentNode->getRight() == currNode && currNode->getBf() < 0) // Right Left	- Z is a right	child of its parent X and BF(Z) < 0
 			{
-				if (parentNode == root)
-				{
-					root = rotateRightLeft(parentNode, currNode);
-				}
-				else
-				{
-					rotateRightLeft(parentNode, currNode);
-				}
+				rotatedNode = rotateRightLeft(parentNode, currNode);
 			}
 			else if (parentNode->getLeft() == currNode && currNode->getBf() <= 0) // Left Left	- Z is a left	child of its parent X and BF(Z) <= 0
 			{
-				if (parentNode == root)
-				{
-					root = rotateRight(parentNode, currNode);
-				}
-				else
-				{
-					rotateRight(parentNode, currNode);
-				}
+				rotatedNode = rotateRight(parentNode, currNode);
 			}
 			else if (parentNode->getLeft() == currNode && currNode->getBf() > 0) // Left Right	- Z is a left	child of its parent X and BF(Z) > 0
 			{
-				if (parentNode == root)
-				{
-					root = rotateLeftRight(parentNode, currNode);
-				}
-				else
-				{
-					rotateLeftRight(parentNode, currNode);
-				}
+				rotatedNode = rotateLeftRight(parentNode, currNode);
 			}
 			else
 			{
 				std::cout << "[rebalanceTreeInsertion] bfParent: " << bfParent << " , the else branch is reached which should not happen!";
+				return;
+			}
+
+			if (parentNode == root)
+			{
+				root = rotatedNode;
+			}
+
+			// After an insertion the rotated subtree has its old height again. Only a grown child with bf 0,
+			// which happens when insertBatch joins subtrees, leaves the rotated subtree one higher.
+			auto parentRotatedNode = rotatedNode->getParent();
+			if (rotatedNode->getBf() != 0 && parentRotatedNode != nullptr)
+			{
+				return rebalanceTreeInsertion(parentRotatedNode, rotatedNode,
+											  isRightChild(parentRotatedNode, rotatedNode) ? INCREMENT_BF : DECREMENT_BF);
 			}
 		}
 		else // tree from parent node is balanced (invariant holds true), no need for rotation
@@ -520,13 +1025,14 @@ private:
 		}
 	}
 
-	void rebalanceTreeDeletion(AVLNode<T> *currNode, const signed char bfDiff)
+	void rebalanceTreeDeletion(Node *currNode, const signed char bfDiff)
 	{
 		if (currNode == nullptr)
 		{
 			return;
 		}
 
+		AVL_STATS(++walkLength;)
 		// increment/decrement bf value of parent node
 		currNode->setBf(currNode->getBf() + bfDiff);
 
@@ -534,7 +1040,7 @@ private:
 
 		// This variable is only used when a rotation happened because of unbalanced tree
 		// In this case next parent would be parent of returned node after rotation.
-		AVLNode<T> *nextParentAfterRotation = nullptr;
+		Node *nextParentAfterRotation = nullptr;
 
 		// Deletion: stop if after deletion of node and modifying bf value of parent of the deleted
 		// node the bf value becomes -1 or +1
@@ -546,7 +1052,7 @@ private:
 		// taking left child as child node for rotation
 		else if (currNodeBf < -1)
 		{
-			AVLNode<T> *currNodeLeft = currNode->getLeft();
+			Node *currNodeLeft = currNode->getLeft();
 			const auto currNodeLeftBf = currNodeLeft->getBf();
 
 			if (currNodeLeftBf <= 0) // Left Left	- Z is a left	child of its parent X and BF(Z) <= 0
@@ -573,7 +1079,7 @@ private:
 		// the parent has unbalanced subtrees and is right-heavy (invariant is violated)
 		else if (currNodeBf > 1)
 		{
-			AVLNode<T> *currNodeRight = currNode->getRight();
+			Node *currNodeRight = currNode->getRight();
 			const auto currNodeRightBf = currNodeRight->getBf();
 
 			if (currNodeRightBf >= 0) // Right Right	- Z is a right	child of its parent X and BF(Z) >= 0
@@ -598,7 +1104,13 @@ private:
 			}
 		}
 
-		AVLNode<T> *nextParent = nullptr;
+		// a rotation of a child with bf 0 leaves the height of the subtree unchanged, no updates needed above it
+		if (nextParentAfterRotation != nullptr && nextParentAfterRotation->getBf() != 0)
+		{
+			return;
+		}
+
+		Node *nextParent = nullptr;
 
 		if (nextParentAfterRotation == nullptr)
 		{
@@ -628,14 +1140,16 @@ private:
 		}
 	}
 
-	AVLNode<T> *insertNode(
+	template <typename... Args>
+	_AVL_inserted_Pair insertNode(
 		const T &data,
-		AVLNode<T> *currNode)
+		Node *currNode,
+		Args &&...args)
 	{
 		if (root == nullptr)
 		{
-			root = new AVLNode<T>(data);
-			return root;
+			root = new Node(nullptr, std::forward<Args>(args)...);
+			return std::make_pair(root, true);
 		}
 		else if (currNode != nullptr)
 		{
@@ -643,30 +1157,30 @@ private:
 			{
 				if (currNode->hasLeft())
 				{
-					return insertNode(data, currNode->getLeft());
+					return insertNode(data, currNode->getLeft(), std::forward<Args>(args)...);
 				}
 				else
 				{
-					currNode->setLeft(new AVLNode<T>(data, currNode));
-					return currNode->getLeft();
+					currNode->setLeft(new Node(currNode, std::forward<Args>(args)...));
+					return std::make_pair(currNode->getLeft(), true);
 				}
 			}
 			else if (data > currNode->getData())
 			{
 				if (currNode->hasRight())
 				{
-					return insertNode(data, currNode->getRight());
+					return insertNode(data, currNode->getRight(), std::forward<Args>(args)...);
 				}
 				else
 				{
-					currNode->setRight(new AVLNode<T>(data, currNode));
-					return currNode->getRight();
+					currNode->setRight(new Node(currNode, std::forward<Args>(args)...));
+					return std::make_pair(currNode->getRight(), true);
 				}
 			}
 		}
 
-		// don't add a node with the same data value twice, just return nullptr
-		return nullptr;
+		// don't add a node with the same data value twice, just return the existing node
+		return std::make_pair(currNode, false);
 	}
 
 	/*
@@ -675,215 +1189,457 @@ private:
 	 * 	1: The BF of successor node should be replaced with the BF of the removed node
 	 *	2: After deletion, the parent before deletion of the node that is used to replace the deleted
 	 *       node should be used to recursivly update BF values of parent nodes until BF of -1 or 1 is found
+	 * Returns the node from which the rebalancing starts and whether its right subtree became lower.
 	 */
-	_AVL_fromRight_Pair removeNode(
-		const T &data,
-		AVLNode<T> *currNode)
+	_AVL_fromRight_Pair removeNode(Node *currNode)
+	{
+		// There are 4 options for deletion:
+		//	1: currNode has no children -> let the parent point to nullptr and then delete the currNode
+		//	2: currNode has only left child -> make the parent left/right ref point to left child of the currNode and delete the old currNode
+		//	3: currNode has only right child -> make the parent left/right ref point to right child of the currNode and delete the old currNode
+		//	4: currNode has both children:
+		//		4.1: if the direct right node of currNode does not have a left child, then:
+		//			4.1.1: make the right node the new currNode
+		//			4.1.2: make the left child of old currNode the left child of new currNode
+		//			4.1.3: make parent node point to new currNode
+		//			4.1.4: delete old currNode
+		//		4.2: if the direct right node of currNode does have a left child, then search for inorder successor node by traversing to the deepest left node
+		//		4.3: make successor the new currNode
+		//			4.3.1: if successor has right child, make the left child of parent of the successor point to that child
+		Node *parentNode = currNode->getParent();
+		_AVL_fromRight_Pair rebalanceFrom = std::make_pair(nullptr, false);
+
+		if (!currNode->hasLeft() || !currNode->hasRight())
+		{
+			Node *childCurrNode = currNode->hasLeft() ? currNode->getLeft() : currNode->getRight();
+			if (childCurrNode != nullptr)
+			{
+				childCurrNode->setParent(parentNode); // change parent of child to parent of currNode
+			}
+			if (parentNode != nullptr)
+			{
+				// the subtree of the parent on the side of currNode became lower by 1
+				rebalanceFrom = std::make_pair(parentNode, isRightChild(parentNode, currNode));
+			}
+			replaceNode(currNode, childCurrNode);
+		}
+		else
+		{
+			Node *inorderSuccessorNode = findInorderSuccessor(currNode->getRight());
+			Node *leftCurrNode = currNode->getLeft();
+
+			if (inorderSuccessorNode == currNode->getRight()) // successor node is the direct right node
+			{
+				// right subtree of the successor stays the same, so the right side of the successor became lower
+				rebalanceFrom = std::make_pair(inorderSuccessorNode, true);
+			}
+			else // successor node is somewhere in the tree
+			{
+				Node *parentInorderSuccessorNode = inorderSuccessorNode->getParent();
+				Node *rightOfSuccessorNode = inorderSuccessorNode->getRight();
+				parentInorderSuccessorNode->setLeft(rightOfSuccessorNode); // set left of parent successor to right of successor
+				if (rightOfSuccessorNode != nullptr)
+				{
+					rightOfSuccessorNode->setParent(parentInorderSuccessorNode);
+				}
+				inorderSuccessorNode->setRight(currNode->getRight()); // set right subtree of currNode to the successor
+				currNode->getRight()->setParent(inorderSuccessorNode);
+				// the successor is always the left child of its parent
+				rebalanceFrom = std::make_pair(parentInorderSuccessorNode, false);
+			}
+
+			inorderSuccessorNode->setLeft(leftCurrNode); // set left subtree of currNode to the successor
+			leftCurrNode->setParent(inorderSuccessorNode);
+			inorderSuccessorNode->setParent(parentNode);
+			inorderSuccessorNode->setBf(currNode->getBf()); // bf value should be same as currNode
+			replaceNode(currNode, inorderSuccessorNode);
+		}
+
+		delete currNode;
+		return rebalanceFrom;
+	}
+
+	// let the parent of oldNode (or root) point to newNode
+	inline void replaceNode(Node *oldNode, Node *newNode)
+	{
+		if (oldNode == root)
+		{
+			root = newNode;
+		}
+		else
+		{
+			setChildFromParent(oldNode->getParent(), oldNode, newNode);
+		}
+	}
+
+	// new root of a subtree after insertBatch, its height and the amount of inserted elements
+	struct BatchResult
+	{
+		Node *root;
+		size_t height;
+		size_t inserted;
+		size_t revived = 0; // dead nodes made live again, counted in inserted as well
+	};
+
+	// batches smaller than this are not worth a thread
+	static constexpr size_t PARALLEL_BATCH_THRESHOLD = 4096;
+
+	BatchResult insertBatch(Node *currNode, T *first, T *last, const size_t parallelDepth)
 	{
 		if (currNode == nullptr)
 		{
-			return std::make_pair(nullptr, false);
+			const size_t height = buildBalanced(first, last, nullptr, currNode);
+			return BatchResult{currNode, height, static_cast<size_t>(last - first)};
 		}
 
-		if (data < currNode->getData())
+		currNode->setParent(nullptr);
+		if (first == last)
 		{
-			return removeNode(data, currNode->getLeft());
+			return BatchResult{currNode, subtreeHeight(currNode), 0};
 		}
-		else if (data > currNode->getData())
+
+		// elements left of split belong into the left subtree, elements from splitEnd into the right subtree
+		T *split = std::lower_bound(first, last, currNode->getData());
+		T *splitEnd = (split != last && !(currNode->getData() < *split)) ? split + 1 : split;
+
+		BatchResult leftResult;
+		BatchResult rightResult;
+		if (parallelDepth > 0 && last - first >= static_cast<std::ptrdiff_t>(PARALLEL_BATCH_THRESHOLD))
 		{
-			return removeNode(data, currNode->getRight());
+			// the left and right subtree share no nodes, so they can be updated at the same time
+			auto leftFuture = std::async(std::launch::async, [&]()
+										 { return insertBatch(currNode->getLeft(), first, split, parallelDepth - 1); });
+			rightResult = insertBatch(currNode->getRight(), splitEnd, last, parallelDepth - 1);
+			leftResult = leftFuture.get();
 		}
 		else
 		{
-			// Current node contains the given data.
-			// There are 4 options for deletion:
-			//	1: currNode has no children -> let the parent point to nullptr and then delete the currNode
-			//	2: currNode has only left child -> make left child the new currNode and delete the old currNode
-			//	3: currNode has only right child -> make the parent left/right ref point to right child the currNode and delete the old currNode
-			//	4: currNode has both children:
-			//		4.1: if the direct right node of currNode does not have a left child, then:
-			//			4.1.1: make the right node the new currNode
-			//			4.1.2: make the child of new currNode the left child of old currNode
-			//			4.1.3: make parent node point to new currNode
-			//			4.1.4: delete old currNode
-			//		4.2: if the direct right node of currNode does have a left child, then search for inorder successor node by traversing to the deepest left node
-			//		4.3: make successor the new root of the tree
-			//			4.3.1: if successor has right child, make the left child of parent of the successor point to that child
-
-			// TODO: this if statement is only done to change root pointer which is not possible
-			// by changing the currNode pointer. See if somehow reference of pointer can be passed instead
-			// to change the copy of the pointer outside of the function to point somewhere else.
-			if (currNode->getParent() == nullptr) // root contains the value we need to remove
-			{
-				if (!currNode->hasLeft() && !currNode->hasRight())
-				{
-					delete root;
-					root = nullptr;
-					return std::make_pair(root, false);
-				}
-				else if (!currNode->hasRight() && currNode->hasLeft())
-				{
-					AVLNode<T> *leftOfCurrNode = currNode->getLeft(); // get left child of root
-					leftOfCurrNode->setParent(nullptr);				  // set parent of left child to nullptr
-					leftOfCurrNode->setBf(root->getBf());			  // set bf to value of root
-					root = leftOfCurrNode;							  // assign root to left child
-					delete currNode;								  // delete previous root
-					currNode = nullptr;
-					return std::make_pair(root, false); // return pair with root and fromRight bool
-				}
-				else if (currNode->hasRight() && !currNode->hasLeft())
-				{
-					AVLNode<T> *rightOfCurrNode = currNode->getRight(); // get right child of root
-					rightOfCurrNode->setParent(nullptr);				// set parent of right child to nullptr
-					rightOfCurrNode->setBf(root->getBf());				// set bf to value of root
-					root = rightOfCurrNode;								// assign root to right child
-					delete currNode;									// delete previous root
-					currNode = nullptr;
-					return std::make_pair(root, true); // return pair with root and fromRight bool
-				}
-				else
-				{
-					AVLNode<T> *inorderSuccessorNode = findInorderSuccessor(currNode->getRight());
-					AVLNode<T> *parentInorderSuccessorNode = inorderSuccessorNode->getParent();
-
-					// successor node is the direct right node from the root
-					if (inorderSuccessorNode == currNode->getRight())
-					{
-						inorderSuccessorNode->setLeft(root->getLeft()); // set left of successor to left subtree of root
-						inorderSuccessorNode->setParent(nullptr);		// parent is now nullptr since successor is new root
-						inorderSuccessorNode->setBf(root->getBf());		// bf value should be same as root node
-						root = inorderSuccessorNode;					// assign root to inorder successor
-						delete currNode;								// delete previous root
-						currNode = nullptr;
-						return std::make_pair(root, true); // return pair with inorder successor and fromRight bool
-					}
-					else // successor node is somewhere in the tree
-					{
-						AVLNode<T> *rightOfSuccessorNode = inorderSuccessorNode->getRight();
-						parentInorderSuccessorNode->setLeft(rightOfSuccessorNode); // set left of parent successor to right of successor
-						// if successor has right node, then make parent of right node the parent of successor
-						if (rightOfSuccessorNode != nullptr)
-						{
-							rightOfSuccessorNode->setParent(parentInorderSuccessorNode);
-						}
-						// Set the parent of the successor node parent to the successor itself as it replaces the old root
-						// which, if the parent of successor node is not updated, will be deleted and parent will point to nullptr
-						if (parentInorderSuccessorNode->getParent() == root)
-						{
-							parentInorderSuccessorNode->setParent(inorderSuccessorNode);
-						}
-						inorderSuccessorNode->setLeft(root->getLeft());	  // set left subtree of prev. root to new root
-						inorderSuccessorNode->setRight(root->getRight()); // set right subtree of prev. root to new root
-						inorderSuccessorNode->setParent(nullptr);		  // set parent of inorder successor to nullptr since it is now the root
-						inorderSuccessorNode->setBf(root->getBf());		  // bf value should be same as root node
-						root = inorderSuccessorNode;					  // set inorder successor as the new root
-						delete currNode;								  // delete previous root
-						currNode = nullptr;
-						return std::make_pair(parentInorderSuccessorNode, false); // return parent of successor with fromRight false since it is always the left child
-					}
-				}
-			}
+			leftResult = insertBatch(currNode->getLeft(), first, split, parallelDepth);
+			rightResult = insertBatch(currNode->getRight(), splitEnd, last, parallelDepth);
+		}
+
+		// data equal to a dead node revives it
+		const size_t revived = (splitEnd != split && isDeadNode(currNode)) ? 1 : 0;
+		if (revived != 0)
+			reviveNode(currNode);
+
+		BatchResult result = joinSubtrees(leftResult, currNode, rightResult);
+		result.inserted = leftResult.inserted + rightResult.inserted + revived;
+		result.revived = leftResult.revived + rightResult.revived + revived;
+		return result;
+	}
+
+	// subtrees lower than this are not split further, an AVL subtree of this height has at least 986 nodes
+	static constexpr size_t PARALLEL_GRAIN_HEIGHT = 14;
+
+	static size_t getParallelDepth()
+	{
+		// a few tasks per hardware thread, the subtrees of an AVL tree differ in size and in their dead nodes
+		size_t parallelDepth = 0;
+		for (size_t tasks = 1; tasks < 4 * static_cast<size_t>(std::thread::hardware_concurrency()); tasks *= 2)
+			++parallelDepth;
+		return parallelDepth;
+	}
+
+	template <typename Result, typename Map, typename Reduce>
+	Result reduceSubtree(Node *currNode, const Result &identity, Map &map, Reduce &reduce, const size_t parallelDepth)
+	{
+		if (parallelDepth == 0 || subtreeHeight(currNode) < PARALLEL_GRAIN_HEIGHT)
+		{
+			Result result = identity;
+			accumulateSubtree(currNode, result, map, reduce);
+			return result;
+		}
+
+		// the left and right subtree share no nodes, so they can be reduced at the same time
+		auto leftFuture = std::async(std::launch::async, [&]()
+									 { return reduceSubtree(currNode->getLeft(), identity, map, reduce, parallelDepth - 1); });
+		Result rightResult = reduceSubtree(currNode->getRight(), identity, map, reduce, parallelDepth - 1);
+		Result result = leftFuture.get();
+		if (!isDeadNode(currNode))
+			result = reduce(std::move(result), map(currNode->getData()));
+		return reduce(std::move(result), std::move(rightResult));
+	}
+
+	template <typename Result, typename Map, typename Reduce>
+	void accumulateSubtree(Node *currNode, Result &result, Map &map, Reduce &reduce)
+	{
+		if (currNode != nullptr)
+		{
+			accumulateSubtree(currNode->getLeft(), result, map, reduce);
+			if (!isDeadNode(currNode))
+				result = reduce(std::move(result), map(currNode->getData()));
+			accumulateSubtree(currNode->getRight(), result, map, reduce);
+		}
+	}
+
+	template <typename Visitor>
+	void forEachSubtree(Node *currNode, Visitor &visitor, const size_t parallelDepth)
+	{
+		if (currNode == nullptr)
+			return;
+
+		if (parallelDepth > 0 && subtreeHeight(currNode) >= PARALLEL_GRAIN_HEIGHT)
+		{
+			auto leftFuture = std::async(std::launch::async, [&]()
+										 { forEachSubtree(currNode->getLeft(), visitor, parallelDepth - 1); });
+			forEachSubtree(currNode->getRight(), visitor, parallelDepth - 1);
+			if (!isDeadNode(currNode))
+				visitor(currNode->getData());
+			leftFuture.get();
+		}
+		else
+		{
+			forEachSubtree(currNode->getLeft(), visitor, 0);
+			if (!isDeadNode(currNode))
+				visitor(currNode->getData());
+			forEachSubtree(currNode->getRight(), visitor, 0);
+		}
+	}
+
+	// builds a perfectly balanced subtree from sorted data and returns its height
+	size_t buildBalanced(T *first, T *last, Node *parentNode, Node *&subtreeRoot)
+	{
+		if (first == last)
+		{
+			subtreeRoot = nullptr;
+			return 0;
+		}
+
+		T *middle = first + (last - first) / 2;
+		subtreeRoot = new Node(parentNode, std::move(*middle));
+
+		Node *leftNode = nullptr;
+		Node *rightNode = nullptr;
+		const size_t leftHeight = buildBalanced(first, middle, subtreeRoot, leftNode);
+		const size_t rightHeight = buildBalanced(middle + 1, last, subtreeRoot, rightNode);
+		subtreeRoot->setLeft(leftNode);
+		subtreeRoot->setRight(rightNode);
+		subtreeRoot->setBf(static_cast<signed char>(static_cast<int>(rightHeight) - static_cast<int>(leftHeight)));
+		updateSubtree(subtreeRoot);
+		return std::max(leftHeight, rightHeight) + 1;
+	}
+
+	/*
+	 * Joins two detached subtrees with joinNode in between, where every element of left is smaller than joinNode and
+	 * every element of right larger. If the heights differ by more than 1, joinNode is hung into the spine of the
+	 * higher subtree where the heights match, and that subtree is rebalanced as if joinNode had been inserted there.
+	 */
+	BatchResult joinSubtrees(const BatchResult &left, Node *joinNode, const BatchResult &right)
+	{
+		const bool leftIsHigher = left.height > right.height + 1;
+		const bool rightIsHigher = right.height > left.height + 1;
+
+		if (!leftIsHigher && !rightIsHigher)
+		{
+			linkJoinNode(joinNode, left.root, right.root, nullptr, static_cast<int>(right.height) - static_cast<int>(left.height));
+			return BatchResult{joinNode, std::max(left.height, right.height) + 1, 0};
+		}
+
+		// walk down the inner spine of the higher subtree until the height fits next to the lower subtree
+		const BatchResult &higher = leftIsHigher ? left : right;
+		const BatchResult &lower = leftIsHigher ? right : left;
+		Node *spineNode = higher.root;
+		size_t spineHeight = higher.height;
+		Node *parentSpineNode = nullptr;
+		while (spineHeight > lower.height + 1)
+		{
+			parentSpineNode = spineNode;
+			const bool lowerChild = leftIsHigher ? spineNode->getBf() < 0 : spineNode->getBf() > 0;
+			spineHeight -= lowerChild ? 2 : 1;
+			spineNode = leftIsHigher ? spineNode->getRight() : spineNode->getLeft();
+		}
+
+		if (leftIsHigher)
+		{
+			linkJoinNode(joinNode, spineNode, right.root, parentSpineNode, static_cast<int>(right.height) - static_cast<int>(spineHeight));
+			parentSpineNode->setRight(joinNode);
+			updatePathToRoot(joinNode);
+			rebalanceTreeInsertion(parentSpineNode, joinNode, INCREMENT_BF);
+		}
+		else
+		{
+			linkJoinNode(joinNode, left.root, spineNode, parentSpineNode, static_cast<int>(spineHeight) - static_cast<int>(left.height));
+			parentSpineNode->setLeft(joinNode);
+			updatePathToRoot(joinNode);
+			rebalanceTreeInsertion(parentSpineNode, joinNode, DECREMENT_BF);
+		}
+
+		// rotations may have moved the root of the higher subtree
+		Node *joinedRoot = joinNode;
+		while (joinedRoot->hasParent())
+		{
+			joinedRoot = joinedRoot->getParent();
+		}
+		return BatchResult{joinedRoot, subtreeHeight(joinedRoot), 0};
+	}
+
+	inline void linkJoinNode(Node *joinNode, Node *leftNode, Node *rightNode, Node *parentNode, const int bf)
+	{
+		joinNode->setLeft(leftNode);
+		joinNode->setRight(rightNode);
+		joinNode->setParent(parentNode);
+		joinNode->setBf(static_cast<signed char>(bf));
+		if (leftNode != nullptr)
+			leftNode->setParent(joinNode);
+		if (rightNode != nullptr)
+			rightNode->setParent(joinNode);
+		updateSubtree(joinNode);
+	}
+
+	// the height follows from the balance factors along the higher side
+	static size_t subtreeHeight(Node *currNode)
+	{
+		size_t height = 0;
+		while (currNode != nullptr)
+		{
+			++height;
+			currNode = currNode->getBf() < 0 ? currNode->getLeft() : currNode->getRight();
+		}
+		return height;
+	}
+
+	static constexpr bool IS_AUGMENTED = isAugmentedAVLNode<Node>::value;
+	static constexpr bool HAS_TOMBSTONE = hasAVLTombstone<Node>::value;
+
+	inline bool isDeadNode(Node *currNode)
+	{
+		if constexpr (HAS_TOMBSTONE)
+		{
+			return currNode != nullptr && currNode->isDead();
+		}
+		return false;
+	}
+
+	inline void reviveNode(Node *currNode)
+	{
+		if constexpr (HAS_TOMBSTONE)
+		{
+			currNode->setDead(false);
+		}
+	}
+
+	// in-order traversal which collects the live nodes and deletes the dead ones
+	void collectLiveNodes(Node *currNode, std::vector<Node *> &liveNodes)
+	{
+		if (currNode != nullptr)
+		{
+			Node *rightNode = currNode->getRight();
+			collectLiveNodes(currNode->getLeft(), liveNodes);
+			if (isDeadNode(currNode))
+				delete currNode;
 			else
-			{
-				AVLNode<T> *parentNode = currNode->getParent();
+				liveNodes.push_back(currNode);
+			collectLiveNodes(rightNode, liveNodes);
+		}
+	}
 
-				if (!currNode->hasLeft() && !currNode->hasRight())
-				{
-					const auto isRightNode = isRightChild(parentNode, currNode); // make sure correct fromRight value is given as it can be right/left depending on parent ref
-					setChildFromParent(parentNode, currNode, nullptr);			 // set parent node approperaite child to nullptr as it is deleted
-					delete currNode;											 // delete the node that needs to be deleted
-					currNode = nullptr;
-					return std::make_pair(parentNode, isRightNode); // return parent node for rebalancing, fromRight bool does not matter
-				}
-				else if (!currNode->hasRight() && currNode->hasLeft())
-				{
-					AVLNode<T> *leftCurrNode = currNode->getLeft();
-					leftCurrNode->setParent(parentNode);					// change parent of left child to parent of currNode
-					leftCurrNode->setBf(currNode->getBf());					// set bf of left child to bf of currNode
-					setChildFromParent(parentNode, currNode, leftCurrNode); // update parent ref to point to the new child
-					delete currNode;										// delete currNode
-					currNode = nullptr;
-					return std::make_pair(leftCurrNode, false); // return new child of the parent for rebalancing with fromRight false
-				}
-				else if (currNode->hasRight() && !currNode->hasLeft())
-				{
-					AVLNode<T> *rightCurrNode = currNode->getRight();
-					rightCurrNode->setParent(parentNode);					 // change parent of right child to parent of currNode
-					rightCurrNode->setBf(currNode->getBf());				 // set bf of right child to bf of currNode
-					setChildFromParent(parentNode, currNode, rightCurrNode); // update parent ref to point to the new child
-					delete currNode;										 // delete currNode
-					currNode = nullptr;
-					return std::make_pair(rightCurrNode, true); // return new child of the parent for rebalancing with fromRight is true
-				}
-				else
-				{
-					AVLNode<T> *inorderSuccessorNode = findInorderSuccessor(currNode->getRight());
-					AVLNode<T> *parentInorderSuccessorNode = inorderSuccessorNode->getParent();
-
-					// successor node is the direct right node from the root
-					if (inorderSuccessorNode == currNode->getRight())
-					{
-						inorderSuccessorNode->setLeft(currNode->getLeft()); // set left of successor to left subtree of currNode
-						inorderSuccessorNode->setParent(parentNode);		// parent is now parentNode
-						inorderSuccessorNode->setBf(currNode->getBf());		// bf value should be same as currNode
-						setChildFromParent(parentNode, currNode, inorderSuccessorNode);
-						delete currNode; // delete currNode
-						currNode = nullptr;
-						return std::make_pair(inorderSuccessorNode, true); // return pair with inorder successor and fromRight bool
-					}
-					else // successor node is somewhere in the tree
-					{
-						AVLNode<T> *rightOfSuccessorNode = inorderSuccessorNode->getRight();
-						parentInorderSuccessorNode->setLeft(rightOfSuccessorNode); // set left of parent successor to right of successor
-						// if successor has right node, then make parent of right node the parent of successor
-						if (rightOfSuccessorNode != nullptr)
-						{
-							rightOfSuccessorNode->setParent(parentInorderSuccessorNode);
-						}
-						// Set the parent of the successor node parent to the successor itself as it replaces the currNode
-						// which, if the parent of successor node is not updated, will be deleted and parent will point to nullptr
-						if (parentInorderSuccessorNode->getParent() == currNode)
-						{
-							parentInorderSuccessorNode->setParent(inorderSuccessorNode);
-						}
-						inorderSuccessorNode->setLeft(currNode->getLeft());				// set left subtree of prev. root to new root
-						inorderSuccessorNode->setRight(currNode->getRight());			// set right subtree of prev. root to new root
-						inorderSuccessorNode->setParent(parentNode);					// set parent of inorder successor to parentNode
-						inorderSuccessorNode->setBf(currNode->getBf());					// bf value should be same as inorder successor
-						setChildFromParent(parentNode, currNode, inorderSuccessorNode); // set inorder successor as the new root
-						delete currNode;												// delete previous root
-						currNode = nullptr;
-						return std::make_pair(parentInorderSuccessorNode, false); // return parent of successor with fromRight false since it is always the left child
-					}
-				}
+	// links sorted nodes as perfectly balanced subtree and returns its height, like buildBalanced
+	size_t linkBalanced(Node **first, Node **last, Node *parentNode, Node *&subtreeRoot)
+	{
+		if (first == last)
+		{
+			subtreeRoot = nullptr;
+			return 0;
+		}
+
+		Node **middle = first + (last - first) / 2;
+		subtreeRoot = *middle;
+
+		Node *leftNode = nullptr;
+		Node *rightNode = nullptr;
+		const size_t leftHeight = linkBalanced(first, middle, subtreeRoot, leftNode);
+		const size_t rightHeight = linkBalanced(middle + 1, last, subtreeRoot, rightNode);
+		subtreeRoot->setParent(parentNode);
+		subtreeRoot->setLeft(leftNode);
+		subtreeRoot->setRight(rightNode);
+		subtreeRoot->setBf(static_cast<signed char>(static_cast<int>(rightHeight) - static_cast<int>(leftHeight)));
+		updateSubtree(subtreeRoot);
+		return std::max(leftHeight, rightHeight) + 1;
+	}
+
+	// recomputes the subtree value of a node from its children, nothing to do for plain nodes
+	inline void updateSubtree(Node *currNode)
+	{
+		if constexpr (IS_AUGMENTED)
+		{
+			currNode->updateFromChildren();
+		}
+	}
+
+	// recomputes the subtree values from currNode up to the root (or the root of a detached subtree)
+	inline void updatePathToRoot(Node *currNode)
+	{
+		if constexpr (IS_AUGMENTED)
+		{
+			for (; currNode != nullptr; currNode = currNode->getParent())
+			{
+				currNode->updateFromChildren();
 			}
 		}
 	}
 
-	void cleanUpTree(AVLNode<T> *currNode)
+	void collectInorder(Node *currNode, std::vector<const T *> &sortedData)
 	{
-		// Post-order traversal to delete and free up memory taken by each node.
-		// First the left three and right tree are visited and deleted first and then the current node is deleted so
-		// that everything descendent node is deleted first before deleting the current node to not lose reference
-		// and cause memory leaks.
 		if (currNode != nullptr)
+		{
+			collectInorder(currNode->getLeft(), sortedData);
+			if (!isDeadNode(currNode))
+				sortedData.push_back(&currNode->getData());
+			collectInorder(currNode->getRight(), sortedData);
+		}
+	}
+
+	static void cleanUpTree(Node *currNode)
+	{
+		// rotate left children up until currNode has none, then it can be deleted without recursing
+		while (currNode != nullptr)
 		{
 			if (currNode->hasLeft())
 			{
-				cleanUpTree(currNode->getLeft());
+				Node *leftNode = currNode->getLeft();
+				currNode->setLeft(leftNode->getRight());
+				leftNode->setRight(currNode);
+				currNode = leftNode;
 			}
-
-			if (currNode->hasRight())
+			else
 			{
-				cleanUpTree(currNode->getRight());
+				Node *rightNode = currNode->getRight();
+				delete currNode;
+				currNode = rightNode;
 			}
+		}
+	}
 
-			delete currNode;
+	// frees the subtrees below the top parallelDepth levels on separate threads, like forEachSubtree
+	static void cleanUpTreeParallel(Node *currNode, const size_t parallelDepth)
+	{
+		TRACE_SCOPE("AVLTree::cleanUpTreeParallel");
+		if (parallelDepth == 0 || subtreeHeight(currNode) < PARALLEL_GRAIN_HEIGHT)
+		{
+			cleanUpTree(currNode);
+			return;
 		}
+
+		Node *leftNode = currNode->getLeft();
+		Node *rightNode = currNode->getRight();
+		delete currNode;
+		auto leftFuture = std::async(std::launch::async, [leftNode, parallelDepth]()
+									 { cleanUpTreeParallel(leftNode, parallelDepth - 1); });
+		cleanUpTreeParallel(rightNode, parallelDepth - 1);
+		leftFuture.get();
 	}
 
 private:
-	AVLNode<T> *root;
+	Node *root;
 	const signed char INCREMENT_BF = 1;
 	const signed char DECREMENT_BF = -1;
+	size_t nodeCount = 0;			  // nodes in the tree including dead ones
+	size_t deadCount = 0;			  // nodes marked dead by removeNodeLazy
+	double compactionThreshold = 0.25; // fraction of dead nodes at which removeNodeLazy compacts
+#if defined(AVL_TREE_STATS)
+	AVLTreeStats stats;
+	size_t walkLength = 0;	// nodes updated by the current rebalancing walk
+	size_t searchDepth = 0; // nodes visited by the current search
+#endif
 };
\ No newline at end of file
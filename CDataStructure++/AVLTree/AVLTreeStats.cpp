@@ -0,0 +1 @@
+#include <AVLTreeStats.h>
\ No newline at end of file
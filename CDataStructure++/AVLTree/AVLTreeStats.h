@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <iostream>
+
+/*
+ * Counters of an AVLTree, only collected if the tree is compiled with AVL_TREE_STATS defined
+ * (cmake -DENABLE_AVL_TREE_STATS=ON). Without it the counting code is removed by the preprocessor.
+ *
+ * A walk length is the amount of nodes whose balance factor was updated after one insertNode/removeNode,
+ * a search depth the amount of nodes visited by one searchNode.
+ */
+struct AVLTreeStats
+{
+	static constexpr size_t HISTOGRAM_SIZE = 64; // lengths of HISTOGRAM_SIZE - 1 and more share the last bucket
+	using Histogram = std::array<size_t, HISTOGRAM_SIZE>;
+
+	size_t rotationsLeft = 0;
+	size_t rotationsRight = 0;
+	size_t rotationsLeftRight = 0;
+	size_t rotationsRightLeft = 0;
+
+	Histogram insertionWalkLengths{};
+	Histogram deletionWalkLengths{};
+	Histogram searchDepths{};
+
+	size_t nodeCount = 0;
+	size_t height = 0; // computed when the stats are requested
+
+	static inline void record(Histogram &histogram, const size_t length)
+	{
+		++histogram[length < HISTOGRAM_SIZE ? length : HISTOGRAM_SIZE - 1];
+	}
+
+	size_t getTotalRotations() const
+	{
+		return rotationsLeft + rotationsRight + rotationsLeftRight + rotationsRightLeft;
+	}
+
+	void printStats() const
+	{
+		std::cout << "nodes: " << nodeCount << ", height: " << height << "\n";
+		std::cout << "rotations left: " << rotationsLeft << ", right: " << rotationsRight
+				  << ", left-right: " << rotationsLeftRight << ", right-left: " << rotationsRightLeft << "\n";
+		printHistogram("insertion walk lengths", insertionWalkLengths);
+		printHistogram("deletion walk lengths", deletionWalkLengths);
+		printHistogram("search depths", searchDepths);
+	}
+
+private:
+	static void printHistogram(const char *name, const Histogram &histogram)
+	{
+		std::cout << name << ":";
+		for (size_t length = 0; length < HISTOGRAM_SIZE; ++length)
+		{
+			if (histogram[length] != 0)
+				std::cout << " " << length << "=" << histogram[length];
+		}
+		std::cout << "\n";
+	}
+};
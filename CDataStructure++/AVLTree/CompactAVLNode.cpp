@@ -0,0 +1 @@
+#include <CompactAVLNode.h>
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+// Parent link of a CompactAVLNode, empty (and optimized away as empty base) if the node has no parent pointer
+template <typename Node, bool HasParent>
+class CompactAVLParentLink
+{
+public:
+	inline bool hasParent() const
+	{
+		return parent != nullptr;
+	}
+
+	inline Node *getParent()
+	{
+		return parent;
+	}
+
+	inline void setParent(Node *newParent)
+	{
+		this->parent = newParent;
+	}
+
+private:
+	Node *parent = nullptr; // pointer to parent node
+};
+
+template <typename Node>
+class CompactAVLParentLink<Node, false>
+{
+};
+
+/*
+ * Compact variant of AVLNode. The balance factor is stored in the low bits of the left pointer, which are
+ * always 0 since nodes are at least 8 byte aligned, so it does not take up a padded word of its own.
+ *
+ * HasParent = true keeps the parent pointer and can be used as node type of AVLTree (AVLTree<T, CompactAVLNode<T, true>>).
+ * HasParent = false drops the parent pointer as well and is used by CompactAVLTree, which rebalances along a
+ * search-path stack instead. For int data the node takes 24 bytes instead of 40.
+ */
+template <typename T, bool HasParent = false>
+class CompactAVLNode : public CompactAVLParentLink<CompactAVLNode<T, HasParent>, HasParent>
+{
+public:
+	// constructs the data in place from args, the parent is ignored if the node has no parent pointer
+	template <typename... Args>
+	explicit CompactAVLNode(
+		CompactAVLNode *parent,
+		Args &&...args)
+		: data(std::forward<Args>(args)...),
+		  leftAndBf(BF_OFFSET), // each node inserted starts off with balance factor of 0 since it is a leaf node
+		  right(nullptr)
+	{
+		if constexpr (HasParent)
+		{
+			this->setParent(parent);
+		}
+	}
+
+	inline const signed char getBf() const
+	{
+		return static_cast<signed char>(static_cast<int>(leftAndBf & BF_MASK) - BF_OFFSET);
+	}
+
+	// AVLTree temporarily stores a bf of -2 or 2 before rotating, which is why 3 tag bits are used
+	inline void setBf(const signed char newBf)
+	{
+		this->leftAndBf = (leftAndBf & ~BF_MASK) | static_cast<uintptr_t>(newBf + BF_OFFSET);
+	}
+
+	inline void setLeft(CompactAVLNode *newLeft)
+	{
+		this->leftAndBf = reinterpret_cast<uintptr_t>(newLeft) | (leftAndBf & BF_MASK);
+	}
+
+	inline void setRight(CompactAVLNode *newRight)
+	{
+		this->right = newRight;
+	}
+
+	inline const T &getData() const
+	{
+		return data;
+	}
+
+	inline bool hasLeft() const
+	{
+		return (leftAndBf & ~BF_MASK) != 0;
+	}
+
+	inline bool hasRight() const
+	{
+		return right != nullptr;
+	}
+
+	inline CompactAVLNode *getLeft() const
+	{
+		return reinterpret_cast<CompactAVLNode *>(leftAndBf & ~BF_MASK);
+	}
+
+	inline CompactAVLNode *getRight() const
+	{
+		return right;
+	}
+
+private:
+	static constexpr uintptr_t BF_MASK = 0x7; // low 3 bits of the left pointer
+	static constexpr int BF_OFFSET = 2;		  // bf -2..2 is stored as 0..4
+
+	const T data;			// data present in the node
+	uintptr_t leftAndBf;	// pointer to left node, balance factor in the low bits
+	CompactAVLNode *right;	// pointer to right node
+};
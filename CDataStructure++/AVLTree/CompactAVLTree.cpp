@@ -0,0 +1 @@
+#include <CompactAVLTree.h>
\ No newline at end of file
@@ -0,0 +1,375 @@
+#pragma once
+#include <CompactAVLNode.h>
+#include <Trace.h>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+/*
+ * AVL tree on CompactAVLNode without parent pointers. Instead of walking up the parent pointers to rebalance,
+ * insertNode/removeNode remember the search path on a fixed-size stack.
+ * Same rotations and balance factor updates as AVLTree, but more nodes fit into the cache during searchNode.
+ */
+template <typename T>
+class CompactAVLTree
+{
+public:
+	using Node = CompactAVLNode<T, false>;
+
+	static_assert(alignof(Node) >= 8, "the low 3 bits of node pointers are needed for the balance factor");
+
+public:
+	CompactAVLTree()
+		: root(nullptr)
+	{
+	}
+
+	CompactAVLTree(const T &data)
+		: root(new Node(nullptr, data))
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	CompactAVLTree(const CompactAVLTree &) = delete;
+	CompactAVLTree(CompactAVLTree &&) = delete;
+
+	~CompactAVLTree()
+	{
+		cleanUpTree(root);
+	}
+
+	void printTree()
+	{
+		std::cout << "Printing the Compact AVL Tree\n";
+		std::cout << "|-- = left node (value < parent value)\n";
+		std::cout << "\\-- = right/root node (value > parent value)\n\n";
+		printTree("", root, false);
+	}
+
+	Node *getRoot()
+	{
+		return root;
+	}
+
+	Node *searchNode(const T &data)
+	{
+		Node *currNode = root;
+		while (currNode != nullptr)
+		{
+			if (data < currNode->getData())
+			{
+				currNode = currNode->getLeft();
+			}
+			else if (data > currNode->getData())
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				return currNode;
+			}
+		}
+		return nullptr;
+	}
+
+	/*
+	 *	Insert given data. Returns false if the data was already present.
+	 */
+	bool insertNode(const T &data)
+	{
+		SearchPath path;
+		Node *currNode = root;
+		while (currNode != nullptr)
+		{
+			if (data < currNode->getData())
+			{
+				path.push(currNode, false);
+				currNode = currNode->getLeft();
+			}
+			else if (data > currNode->getData())
+			{
+				path.push(currNode, true);
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				// don't add a node with the same data value twice
+				return false;
+			}
+		}
+
+		Node *insertedNode = new Node(nullptr, data);
+		setChild(path, path.size, insertedNode);
+		rebalanceTreeInsertion(path);
+		return true;
+	}
+
+	/*
+	 *	Remove node with given data. Returns false if no node with the given data exists.
+	 */
+	bool removeNode(const T &data)
+	{
+		SearchPath path;
+		Node *currNode = root;
+		while (currNode != nullptr && !(currNode->getData() == data))
+		{
+			const bool goRight = data > currNode->getData();
+			path.push(currNode, goRight);
+			currNode = goRight ? currNode->getRight() : currNode->getLeft();
+		}
+
+		if (currNode == nullptr)
+			return false;
+
+		const size_t removedIdx = path.size;
+
+		if (!currNode->hasLeft() || !currNode->hasRight())
+		{
+			// replace the node with its only child (or nothing), its parent lost height on the side of the node
+			setChild(path, removedIdx, currNode->hasLeft() ? currNode->getLeft() : currNode->getRight());
+		}
+		else
+		{
+			// the inorder successor takes the place of the removed node, its old parent lost height on the left
+			path.push(currNode, true);
+			Node *inorderSuccessorNode = currNode->getRight();
+			while (inorderSuccessorNode->hasLeft())
+			{
+				path.push(inorderSuccessorNode, false);
+				inorderSuccessorNode = inorderSuccessorNode->getLeft();
+			}
+
+			setChild(path, path.size, inorderSuccessorNode->getRight());
+			inorderSuccessorNode->setLeft(currNode->getLeft());
+			inorderSuccessorNode->setRight(currNode->getRight());
+			inorderSuccessorNode->setBf(currNode->getBf());
+			setChild(path, removedIdx, inorderSuccessorNode);
+			path.nodes[removedIdx] = inorderSuccessorNode;
+		}
+
+		delete currNode;
+		rebalanceTreeDeletion(path);
+		return true;
+	}
+
+private:
+	// An AVL tree of height 96 would need more nodes than fit into a 64 bit address space
+	static constexpr size_t MAX_HEIGHT = 96;
+
+	// nodes from the root down to the current node and whether the right child was taken at each of them
+	struct SearchPath
+	{
+		Node *nodes[MAX_HEIGHT];
+		bool wentRight[MAX_HEIGHT];
+		size_t size = 0;
+
+		inline void push(Node *node, const bool right)
+		{
+			nodes[size] = node;
+			wentRight[size] = right;
+			++size;
+		}
+	};
+
+	// let the node at path index idx - 1 (or root for idx 0) point to newChild on the side taken on the path
+	inline void setChild(const SearchPath &path, const size_t idx, Node *newChild)
+	{
+		if (idx == 0)
+		{
+			root = newChild;
+		}
+		else if (path.wentRight[idx - 1])
+		{
+			path.nodes[idx - 1]->setRight(newChild);
+		}
+		else
+		{
+			path.nodes[idx - 1]->setLeft(newChild);
+		}
+	}
+
+	void rebalanceTreeInsertion(const SearchPath &path)
+	{
+		// walk up from the parent of the inserted node, the subtree on the path side grew by 1
+		for (size_t i = path.size; i-- > 0;)
+		{
+			Node *currNode = path.nodes[i];
+			const int bf = currNode->getBf() + (path.wentRight[i] ? 1 : -1);
+
+			if (bf == 0)
+			{
+				// Insertion: stop if the bf value becomes 0, the height did not change
+				currNode->setBf(0);
+				return;
+			}
+			else if (bf == 1 || bf == -1)
+			{
+				currNode->setBf(bf);
+			}
+			else
+			{
+				// after the rotation the subtree has the same height as before the insertion
+				setChild(path, i, rotate(currNode, bf));
+				return;
+			}
+		}
+	}
+
+	void rebalanceTreeDeletion(const SearchPath &path)
+	{
+		// walk up from the parent of the removed position, the subtree on the path side became lower by 1
+		for (size_t i = path.size; i-- > 0;)
+		{
+			Node *currNode = path.nodes[i];
+			const int bf = currNode->getBf() + (path.wentRight[i] ? -1 : 1);
+
+			if (bf == 1 || bf == -1)
+			{
+				// Deletion: stop if the bf value becomes -1 or +1, the height did not change
+				currNode->setBf(bf);
+				return;
+			}
+			else if (bf == 0)
+			{
+				currNode->setBf(0);
+			}
+			else
+			{
+				Node *rotatedNode = rotate(currNode, bf);
+				setChild(path, i, rotatedNode);
+				// a rotation of a child with bf 0 leaves the height of the subtree unchanged
+				if (rotatedNode->getBf() != 0)
+					return;
+			}
+		}
+	}
+
+	// rebalances currNode which has a bf of -2 or 2, returns the new root of the subtree
+	Node *rotate(Node *currNode, const int bf)
+	{
+		TRACE_SCOPE("CompactAVLTree::rotate");
+		if (bf > 1)
+		{
+			return currNode->getRight()->getBf() >= 0 ? rotateLeft(currNode) : rotateRightLeft(currNode);
+		}
+		return currNode->getLeft()->getBf() <= 0 ? rotateRight(currNode) : rotateLeftRight(currNode);
+	}
+
+	/*
+	 * SIMPLE ROTATION - LEFT CASE: right child Z of X (parentNode) is higher and BF(Z) >= 0
+	 */
+	Node *rotateLeft(Node *parentNode)
+	{
+		Node *currNode = parentNode->getRight();
+		parentNode->setRight(currNode->getLeft());
+		currNode->setLeft(parentNode);
+
+		if (currNode->getBf() == 0)
+		{
+			// only happens with deletion
+			parentNode->setBf(1);
+			currNode->setBf(-1);
+		}
+		else
+		{
+			parentNode->setBf(0);
+			currNode->setBf(0);
+		}
+		return currNode;
+	}
+
+	/*
+	 * SIMPLE ROTATION - RIGHT CASE: left child Z of X (parentNode) is higher and BF(Z) <= 0
+	 */
+	Node *rotateRight(Node *parentNode)
+	{
+		Node *currNode = parentNode->getLeft();
+		parentNode->setLeft(currNode->getRight());
+		currNode->setRight(parentNode);
+
+		if (currNode->getBf() == 0)
+		{
+			// only happens with deletion
+			parentNode->setBf(-1);
+			currNode->setBf(1);
+		}
+		else
+		{
+			parentNode->setBf(0);
+			currNode->setBf(0);
+		}
+		return currNode;
+	}
+
+	/*
+	 * DOUBLE ROTATION - RIGHT_LEFT ROTATION: right child Z of X (parentNode) is higher and BF(Z) < 0
+	 */
+	Node *rotateRightLeft(Node *parentNode)
+	{
+		Node *currNode = parentNode->getRight();
+		Node *innerChild = currNode->getLeft();
+		const auto innerChildBF = innerChild->getBf();
+
+		currNode->setLeft(innerChild->getRight());
+		parentNode->setRight(innerChild->getLeft());
+		innerChild->setLeft(parentNode);
+		innerChild->setRight(currNode);
+
+		parentNode->setBf(innerChildBF > 0 ? -1 : 0);
+		currNode->setBf(innerChildBF < 0 ? 1 : 0);
+		innerChild->setBf(0);
+		return innerChild;
+	}
+
+	/*
+	 * DOUBLE ROTATION - LEFT_RIGHT ROTATION: left child Z of X (parentNode) is higher and BF(Z) > 0
+	 */
+	Node *rotateLeftRight(Node *parentNode)
+	{
+		Node *currNode = parentNode->getLeft();
+		Node *innerChild = currNode->getRight();
+		const auto innerChildBF = innerChild->getBf();
+
+		currNode->setRight(innerChild->getLeft());
+		parentNode->setLeft(innerChild->getRight());
+		innerChild->setLeft(currNode);
+		innerChild->setRight(parentNode);
+
+		parentNode->setBf(innerChildBF < 0 ? 1 : 0);
+		currNode->setBf(innerChildBF > 0 ? -1 : 0);
+		innerChild->setBf(0);
+		return innerChild;
+	}
+
+	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
+	void printTree(const std::string &prefix, Node *node, bool isLeft)
+	{
+		if (node != nullptr)
+		{
+			std::cout << prefix;
+
+			std::cout << (isLeft ? "|-- " : "\\-- ");
+
+			// print the value of the node
+			std::cout << "(" << node->getData() << ", bf: " << (int)node->getBf() << ")" << std::endl;
+
+			// enter the next tree level - left and right branch
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		}
+	}
+
+	void cleanUpTree(Node *currNode)
+	{
+		// Post-order traversal to delete and free up memory taken by each node.
+		if (currNode != nullptr)
+		{
+			cleanUpTree(currNode->getLeft());
+			cleanUpTree(currNode->getRight());
+			delete currNode;
+		}
+	}
+
+private:
+	Node *root;
+};
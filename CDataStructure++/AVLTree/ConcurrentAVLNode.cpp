@@ -0,0 +1 @@
+#include <ConcurrentAVLNode.h>
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/*
+ * Node of the ConcurrentAVLTree.
+ *
+ * Besides the usual links every node carries a version number (optimistic version lock). The version is only
+ * changed when the subtree below the node shrinks (rotation) or when the node gets unlinked, so readers can
+ * validate that a child they followed was still reachable from this node without taking any lock.
+ * Instead of a balance factor the node stores its height since heights can be repaired independently by
+ * different threads (relaxed balance).
+ */
+template <typename T>
+class ConcurrentAVLNode
+{
+public:
+	static constexpr uint64_t UNLINKED = 1;			 // version of a node that is no longer part of the tree
+	static constexpr uint64_t SHRINKING = 2;		 // set while a rotation moves keys out of this subtree
+	static constexpr uint64_t SHRINK_COUNT_INCR = 4; // every finished shrink bumps the version by this amount
+
+	// constructor for the root holder, its data is never compared
+	ConcurrentAVLNode()
+		: data(),
+		  present(false),
+		  height(0),
+		  version(0),
+		  left(nullptr),
+		  right(nullptr),
+		  parent(nullptr)
+	{
+	}
+
+	explicit ConcurrentAVLNode(
+		const T &data,
+		ConcurrentAVLNode *parent)
+		: data(data),
+		  present(true),
+		  height(1), // each node inserted starts off as a leaf
+		  version(0),
+		  left(nullptr),
+		  right(nullptr),
+		  parent(parent)
+	{
+	}
+
+	inline const T &getData() const
+	{
+		return data;
+	}
+
+	inline bool isPresent() const
+	{
+		return present.load();
+	}
+
+	inline void setPresent(const bool newPresent)
+	{
+		present.store(newPresent);
+	}
+
+	inline int getHeight() const
+	{
+		return height.load(std::memory_order_relaxed);
+	}
+
+	inline void setHeight(const int newHeight)
+	{
+		height.store(newHeight, std::memory_order_relaxed);
+	}
+
+	inline uint64_t getVersion() const
+	{
+		return version.load();
+	}
+
+	inline void setVersion(const uint64_t newVersion)
+	{
+		version.store(newVersion);
+	}
+
+	// direction < 0 is the left child, direction > 0 the right child
+	inline ConcurrentAVLNode *getChild(const int direction) const
+	{
+		return direction < 0 ? getLeft() : getRight();
+	}
+
+	inline ConcurrentAVLNode *getLeft() const
+	{
+		return left.load();
+	}
+
+	inline ConcurrentAVLNode *getRight() const
+	{
+		return right.load();
+	}
+
+	inline ConcurrentAVLNode *getParent() const
+	{
+		return parent.load();
+	}
+
+	inline void setChild(const int direction, ConcurrentAVLNode *newChild)
+	{
+		if (direction < 0)
+			setLeft(newChild);
+		else
+			setRight(newChild);
+	}
+
+	inline void setLeft(ConcurrentAVLNode *newLeft)
+	{
+		left.store(newLeft);
+	}
+
+	inline void setRight(ConcurrentAVLNode *newRight)
+	{
+		right.store(newRight);
+	}
+
+	inline void setParent(ConcurrentAVLNode *newParent)
+	{
+		parent.store(newParent);
+	}
+
+	inline std::mutex &getLock()
+	{
+		return lock;
+	}
+
+	static inline bool isShrinking(const uint64_t version)
+	{
+		return (version & SHRINKING) != 0;
+	}
+
+	static inline uint64_t beginShrink(const uint64_t version)
+	{
+		return version | SHRINKING;
+	}
+
+	static inline uint64_t endShrink(const uint64_t version)
+	{
+		return version + SHRINK_COUNT_INCR;
+	}
+
+private:
+	const T data;						   // data present in the node
+	std::atomic<bool> present;			   // false if the node is only kept as routing node
+	std::atomic<int> height;			   // height of the subtree rooted at this node
+	std::atomic<uint64_t> version;		   // optimistic version, see constants above
+	std::atomic<ConcurrentAVLNode *> left;	 // pointer to left node
+	std::atomic<ConcurrentAVLNode *> right;	 // pointer to right node
+	std::atomic<ConcurrentAVLNode *> parent; // pointer to parent node
+	std::mutex lock;					   // taken by writers that modify this node
+};
@@ -0,0 +1 @@
+#include <ConcurrentAVLTree.h>
\ No newline at end of file
@@ -0,0 +1,769 @@
+#pragma once
+#include <ConcurrentAVLNode.h>
+#include <EpochReclamation.h>
+#include <Trace.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Concurrent AVL tree following "A Practical Concurrent Binary Search Tree" (Bronson et al., PPoPP 2010).
+ *
+ *	- Readers never take a lock. They walk down the tree hand-over-hand and validate, after following a child
+ *	  pointer, that the version of the node they came from did not change in the meantime. If it did, the
+ *	  walk is retried from the last node that is still valid instead of from the root.
+ *	- Writers only lock the node(s) they modify: the parent for an insertion, the parent and the node for
+ *	  an unlink and the (at most 3) nodes involved in a rotation.
+ *	- The tree uses relaxed balance: heights are repaired after the modification by walking up, so the tree
+ *	  can be temporarily out of balance while other threads work on it.
+ *	- Removing a node with two children only marks it as not present (routing node). Routing nodes are
+ *	  spliced out during rebalancing as soon as they have less than 2 children.
+ *
+ * Unlinked nodes can still be reached by readers that are in the middle of a traversal, therefore they are
+ * not freed immediately but retired to an EpochReclamation and freed once no operation can still be reading them.
+ */
+template <typename T>
+class ConcurrentAVLTree
+{
+public:
+	using Node = ConcurrentAVLNode<T>;
+
+public:
+	ConcurrentAVLTree()
+		: rootHolder(new Node())
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	ConcurrentAVLTree(const ConcurrentAVLTree<T> &) = delete;
+	ConcurrentAVLTree(ConcurrentAVLTree<T> &&) = delete;
+
+	~ConcurrentAVLTree()
+	{
+		// no other thread may use the tree anymore, free everything still reachable, the reclamation frees the rest
+		std::vector<Node *> toDelete = {rootHolder};
+		while (!toDelete.empty())
+		{
+			Node *currNode = toDelete.back();
+			toDelete.pop_back();
+			if (currNode->getLeft() != nullptr)
+				toDelete.push_back(currNode->getLeft());
+			if (currNode->getRight() != nullptr)
+				toDelete.push_back(currNode->getRight());
+			delete currNode;
+		}
+	}
+
+	/*
+	 *	Returns true if the data is present in the tree. Does not take any lock.
+	 */
+	bool containsNode(const T &data) const
+	{
+		EpochReclamation::Guard guard(reclamation);
+		// the root holder never shrinks, so the top level attempt can never ask for a retry
+		return attemptGet(data, rootHolder, 1, 0) == AttemptResult::SUCCESS;
+	}
+
+	/*
+	 *	Insert given data. Returns false if the data was already present.
+	 */
+	bool insertNode(const T &data)
+	{
+		EpochReclamation::Guard guard(reclamation);
+		return attemptPut(data, rootHolder, 1, 0, guard) == AttemptResult::SUCCESS;
+	}
+
+	/*
+	 *	Remove node with given data. Returns false if the data was not present.
+	 */
+	bool removeNode(const T &data)
+	{
+		EpochReclamation::Guard guard(reclamation);
+		return attemptRemove(data, rootHolder, 1, 0, guard) == AttemptResult::SUCCESS;
+	}
+
+	/*
+	 *	Height of the tree, only meaningful if no other thread is modifying the tree.
+	 */
+	int getHeight() const
+	{
+		return height(rootHolder->getRight());
+	}
+
+private:
+	enum class AttemptResult
+	{
+		SUCCESS,
+		FAILURE,
+		RETRY
+	};
+
+	// results of nodeCondition(), values >= 0 are the height the node should have
+	static constexpr int UNLINK_REQUIRED = -1;
+	static constexpr int REBALANCE_REQUIRED = -2;
+	static constexpr int NOTHING_REQUIRED = -3;
+
+	// amount of spins before a reader blocks on the lock of a node that is being rotated
+	static constexpr int SPIN_COUNT = 100;
+
+	static inline int height(const Node *node)
+	{
+		return node == nullptr ? 0 : node->getHeight();
+	}
+
+	static inline int compare(const T &data, const Node *node)
+	{
+		if (data < node->getData())
+			return -1;
+		if (data > node->getData())
+			return 1;
+		return 0;
+	}
+
+	static void waitUntilNotChanging(Node *node)
+	{
+		for (int i = 0; i < SPIN_COUNT; ++i)
+		{
+			if (!Node::isShrinking(node->getVersion()))
+				return;
+			std::this_thread::yield();
+		}
+		// the rotating writer holds the lock during the whole shrink, block until it is done
+		std::lock_guard<std::mutex> lock(node->getLock());
+	}
+
+	AttemptResult attemptGet(const T &data, Node *node, const int direction, const uint64_t nodeVersion) const
+	{
+		while (true)
+		{
+			Node *child = node->getChild(direction);
+			if (node->getVersion() != nodeVersion)
+				return AttemptResult::RETRY;
+
+			if (child == nullptr)
+				return AttemptResult::FAILURE;
+
+			const int nextDirection = compare(data, child);
+			if (nextDirection == 0)
+				return child->isPresent() ? AttemptResult::SUCCESS : AttemptResult::FAILURE;
+
+			const uint64_t childVersion = child->getVersion();
+			if (Node::isShrinking(childVersion))
+			{
+				waitUntilNotChanging(child);
+			}
+			else if (childVersion != Node::UNLINKED && child == node->getChild(direction))
+			{
+				// hand-over-hand: the child is valid if the node we came from did not change
+				if (node->getVersion() != nodeVersion)
+					return AttemptResult::RETRY;
+
+				const auto result = attemptGet(data, child, nextDirection, childVersion);
+				if (result != AttemptResult::RETRY)
+					return result;
+			}
+			// otherwise retry from this node
+		}
+	}
+
+	AttemptResult attemptPut(const T &data, Node *node, const int direction, const uint64_t nodeVersion, EpochReclamation::Guard &guard)
+	{
+		AttemptResult result = AttemptResult::RETRY;
+		do
+		{
+			Node *child = node->getChild(direction);
+			if (node->getVersion() != nodeVersion)
+				return AttemptResult::RETRY;
+
+			if (child == nullptr)
+			{
+				result = attemptInsert(data, node, direction, nodeVersion, guard);
+			}
+			else
+			{
+				const int nextDirection = compare(data, child);
+				if (nextDirection == 0)
+				{
+					result = attemptUpdate(child);
+				}
+				else
+				{
+					const uint64_t childVersion = child->getVersion();
+					if (Node::isShrinking(childVersion))
+					{
+						waitUntilNotChanging(child);
+					}
+					else if (childVersion != Node::UNLINKED && child == node->getChild(direction))
+					{
+						if (node->getVersion() != nodeVersion)
+							return AttemptResult::RETRY;
+						result = attemptPut(data, child, nextDirection, childVersion, guard);
+					}
+				}
+			}
+		} while (result == AttemptResult::RETRY);
+
+		return result;
+	}
+
+	AttemptResult attemptInsert(const T &data, Node *node, const int direction, const uint64_t nodeVersion, EpochReclamation::Guard &guard)
+	{
+		{
+			std::lock_guard<std::mutex> lock(node->getLock());
+			if (node->getVersion() != nodeVersion || node->getChild(direction) != nullptr)
+				return AttemptResult::RETRY;
+
+			node->setChild(direction, new Node(data, node));
+		}
+
+		fixHeightAndRebalance(node, guard);
+		return AttemptResult::SUCCESS;
+	}
+
+	// node with equal data found, revive it if it is a routing node
+	AttemptResult attemptUpdate(Node *node)
+	{
+		std::lock_guard<std::mutex> lock(node->getLock());
+		if (node->getVersion() == Node::UNLINKED)
+			return AttemptResult::RETRY;
+
+		if (node->isPresent())
+			return AttemptResult::FAILURE;
+
+		node->setPresent(true);
+		return AttemptResult::SUCCESS;
+	}
+
+	AttemptResult attemptRemove(const T &data, Node *node, const int direction, const uint64_t nodeVersion, EpochReclamation::Guard &guard)
+	{
+		AttemptResult result = AttemptResult::RETRY;
+		do
+		{
+			Node *child = node->getChild(direction);
+			if (node->getVersion() != nodeVersion)
+				return AttemptResult::RETRY;
+
+			if (child == nullptr)
+			{
+				return AttemptResult::FAILURE;
+			}
+			else
+			{
+				const int nextDirection = compare(data, child);
+				if (nextDirection == 0)
+				{
+					result = attemptRemoveNode(node, child, guard);
+				}
+				else
+				{
+					const uint64_t childVersion = child->getVersion();
+					if (Node::isShrinking(childVersion))
+					{
+						waitUntilNotChanging(child);
+					}
+					else if (childVersion != Node::UNLINKED && child == node->getChild(direction))
+					{
+						if (node->getVersion() != nodeVersion)
+							return AttemptResult::RETRY;
+						result = attemptRemove(data, child, nextDirection, childVersion, guard);
+					}
+				}
+			}
+		} while (result == AttemptResult::RETRY);
+
+		return result;
+	}
+
+	static inline bool canUnlink(const Node *node)
+	{
+		return node->getLeft() == nullptr || node->getRight() == nullptr;
+	}
+
+	AttemptResult attemptRemoveNode(Node *parentNode, Node *node, EpochReclamation::Guard &guard)
+	{
+		if (!node->isPresent())
+			return AttemptResult::FAILURE;
+
+		if (!canUnlink(node))
+		{
+			// node has 2 children: only turn it into a routing node, no structural change needed
+			std::lock_guard<std::mutex> lock(node->getLock());
+			if (node->getVersion() == Node::UNLINKED || canUnlink(node))
+				return AttemptResult::RETRY;
+
+			if (!node->isPresent())
+				return AttemptResult::FAILURE;
+
+			node->setPresent(false);
+			return AttemptResult::SUCCESS;
+		}
+
+		{
+			std::lock_guard<std::mutex> parentLock(parentNode->getLock());
+			if (parentNode->getVersion() == Node::UNLINKED ||
+				node->getParent() != parentNode ||
+				node->getVersion() == Node::UNLINKED)
+				return AttemptResult::RETRY;
+
+			std::lock_guard<std::mutex> lock(node->getLock());
+			if (!node->isPresent())
+				return AttemptResult::FAILURE;
+
+			node->setPresent(false);
+			if (canUnlink(node))
+			{
+				Node *splice = node->getLeft() == nullptr ? node->getRight() : node->getLeft();
+				if (parentNode->getLeft() == node)
+					parentNode->setLeft(splice);
+				else
+					parentNode->setRight(splice);
+
+				if (splice != nullptr)
+					splice->setParent(parentNode);
+
+				node->setVersion(Node::UNLINKED);
+				guard.retire(node);
+			}
+			// else a child got inserted concurrently, the node stays as routing node
+		}
+
+		fixHeightAndRebalance(parentNode, guard);
+		return AttemptResult::SUCCESS;
+	}
+
+	int nodeCondition(Node *node) const
+	{
+		Node *nodeLeft = node->getLeft();
+		Node *nodeRight = node->getRight();
+
+		if ((nodeLeft == nullptr || nodeRight == nullptr) && !node->isPresent())
+			return UNLINK_REQUIRED;
+
+		const int heightNode = node->getHeight();
+		const int heightLeft = height(nodeLeft);
+		const int heightRight = height(nodeRight);
+
+		// Any thread that changes a node promises to fix it afterwards, so either this snapshot is consistent
+		// or another thread has taken responsibility for the node or one of its children.
+		const int newHeight = 1 + std::max(heightLeft, heightRight);
+		const int balance = heightLeft - heightRight;
+
+		if (balance < -1 || balance > 1)
+			return REBALANCE_REQUIRED;
+
+		return heightNode != newHeight ? newHeight : NOTHING_REQUIRED;
+	}
+
+	void fixHeightAndRebalance(Node *node, EpochReclamation::Guard &guard)
+	{
+		// the root holder is the only node without parent and never needs repairs
+		while (node != nullptr && node->getParent() != nullptr)
+		{
+			const int condition = nodeCondition(node);
+			if (condition == NOTHING_REQUIRED || node->getVersion() == Node::UNLINKED)
+				return;
+
+			if (condition != UNLINK_REQUIRED && condition != REBALANCE_REQUIRED)
+			{
+				std::lock_guard<std::mutex> lock(node->getLock());
+				node = fixHeightLocked(node);
+			}
+			else
+			{
+				Node *parentNode = node->getParent();
+				std::lock_guard<std::mutex> parentLock(parentNode->getLock());
+				if (parentNode->getVersion() != Node::UNLINKED && node->getParent() == parentNode)
+				{
+					std::lock_guard<std::mutex> lock(node->getLock());
+					node = rebalanceLocked(parentNode, node, guard);
+				}
+			}
+		}
+	}
+
+	/*
+	 * All *Locked functions expect the caller to hold the locks of the nodes given as parameter.
+	 * They return the next node that needs to be repaired or nullptr if nothing is left to do.
+	 */
+	Node *fixHeightLocked(Node *node)
+	{
+		const int condition = nodeCondition(node);
+		switch (condition)
+		{
+		case REBALANCE_REQUIRED:
+		case UNLINK_REQUIRED:
+			// can't repair with only the lock of node
+			return node;
+		case NOTHING_REQUIRED:
+			// any future damage to this node is not our responsibility
+			return nullptr;
+		default:
+			node->setHeight(condition);
+			// the parent is damaged now, but it can't be fixed with the locks we hold
+			return node->getParent();
+		}
+	}
+
+	Node *rebalanceLocked(Node *parentNode, Node *node, EpochReclamation::Guard &guard)
+	{
+		Node *nodeLeft = node->getLeft();
+		Node *nodeRight = node->getRight();
+
+		if ((nodeLeft == nullptr || nodeRight == nullptr) && !node->isPresent())
+		{
+			if (attemptUnlinkLocked(parentNode, node, guard))
+			{
+				// try to fix the height of the parent while we still have its lock
+				return fixHeightLocked(parentNode);
+			}
+			return node;
+		}
+
+		const int heightNode = node->getHeight();
+		const int heightLeft = height(nodeLeft);
+		const int heightRight = height(nodeRight);
+		const int newHeight = 1 + std::max(heightLeft, heightRight);
+		const int balance = heightLeft - heightRight;
+
+		if (balance > 1)
+		{
+			return rebalanceToRightLocked(parentNode, node, nodeLeft, heightRight);
+		}
+		else if (balance < -1)
+		{
+			return rebalanceToLeftLocked(parentNode, node, nodeRight, heightLeft);
+		}
+		else if (newHeight != heightNode)
+		{
+			node->setHeight(newHeight);
+			return fixHeightLocked(parentNode);
+		}
+		return nullptr;
+	}
+
+	bool attemptUnlinkLocked(Node *parentNode, Node *node, EpochReclamation::Guard &guard)
+	{
+		Node *parentLeft = parentNode->getLeft();
+		Node *parentRight = parentNode->getRight();
+		if (parentLeft != node && parentRight != node)
+		{
+			// node is no longer a child of parentNode
+			return false;
+		}
+
+		Node *nodeLeft = node->getLeft();
+		Node *nodeRight = node->getRight();
+		if (nodeLeft != nullptr && nodeRight != nullptr)
+		{
+			// splicing is no longer possible
+			return false;
+		}
+
+		Node *splice = nodeLeft != nullptr ? nodeLeft : nodeRight;
+		if (parentLeft == node)
+			parentNode->setLeft(splice);
+		else
+			parentNode->setRight(splice);
+
+		if (splice != nullptr)
+			splice->setParent(parentNode);
+
+		node->setVersion(Node::UNLINKED);
+		guard.retire(node);
+		return true;
+	}
+
+	Node *rebalanceToRightLocked(Node *parentNode, Node *node, Node *nodeLeft, const int heightRight)
+	{
+		TRACE_SCOPE("ConcurrentAVLTree::rebalanceToRightLocked");
+		// left is too high, rotate right. If left.right is higher than left.left, first rotate left around left.
+		std::lock_guard<std::mutex> leftLock(nodeLeft->getLock());
+		const int heightLeft = nodeLeft->getHeight();
+		if (heightLeft - heightRight <= 1)
+			return node; // retry
+
+		Node *nodeLeftRight = nodeLeft->getRight();
+		const int heightLeftLeft = height(nodeLeft->getLeft());
+		const int heightLeftRight = height(nodeLeftRight);
+
+		if (heightLeftLeft >= heightLeftRight)
+			return rotateRightLocked(parentNode, node, nodeLeft, heightRight, heightLeftLeft, nodeLeftRight, heightLeftRight);
+
+		{
+			std::lock_guard<std::mutex> leftRightLock(nodeLeftRight->getLock());
+			// if the snapshot of the height was wrong, a single rotation might be enough after all
+			const int heightLeftRightLocked = nodeLeftRight->getHeight();
+			if (heightLeftLeft >= heightLeftRightLocked)
+				return rotateRightLocked(parentNode, node, nodeLeft, heightRight, heightLeftLeft, nodeLeftRight, heightLeftRightLocked);
+
+			// only do the double rotation if left won't be damaged by it, otherwise first fix left on its own
+			const int heightLeftRightLeft = height(nodeLeftRight->getLeft());
+			const int balance = heightLeftLeft - heightLeftRightLeft;
+			if (balance >= -1 && balance <= 1 &&
+				!((heightLeftLeft == 0 || heightLeftRightLeft == 0) && !nodeLeft->isPresent()))
+			{
+				return rotateRightOverLeftLocked(parentNode, node, nodeLeft, heightRight, heightLeftLeft, nodeLeftRight, heightLeftRightLeft);
+			}
+		}
+
+		// focus on left, if necessary node will be balanced later
+		return rebalanceToLeftLocked(node, nodeLeft, nodeLeftRight, heightLeftLeft);
+	}
+
+	Node *rebalanceToLeftLocked(Node *parentNode, Node *node, Node *nodeRight, const int heightLeft)
+	{
+		TRACE_SCOPE("ConcurrentAVLTree::rebalanceToLeftLocked");
+		std::lock_guard<std::mutex> rightLock(nodeRight->getLock());
+		const int heightRight = nodeRight->getHeight();
+		if (heightLeft - heightRight >= -1)
+			return node; // retry
+
+		Node *nodeRightLeft = nodeRight->getLeft();
+		const int heightRightLeft = height(nodeRightLeft);
+		const int heightRightRight = height(nodeRight->getRight());
+
+		if (heightRightRight >= heightRightLeft)
+			return rotateLeftLocked(parentNode, node, heightLeft, nodeRight, nodeRightLeft, heightRightLeft, heightRightRight);
+
+		{
+			std::lock_guard<std::mutex> rightLeftLock(nodeRightLeft->getLock());
+			const int heightRightLeftLocked = nodeRightLeft->getHeight();
+			if (heightRightRight >= heightRightLeftLocked)
+				return rotateLeftLocked(parentNode, node, heightLeft, nodeRight, nodeRightLeft, heightRightLeftLocked, heightRightRight);
+
+			const int heightRightLeftRight = height(nodeRightLeft->getRight());
+			const int balance = heightRightRight - heightRightLeftRight;
+			if (balance >= -1 && balance <= 1 &&
+				!((heightRightRight == 0 || heightRightLeftRight == 0) && !nodeRight->isPresent()))
+			{
+				return rotateLeftOverRightLocked(parentNode, node, heightLeft, nodeRight, nodeRightLeft, heightRightRight, heightRightLeftRight);
+			}
+		}
+
+		return rebalanceToRightLocked(node, nodeRight, nodeRightLeft, heightRightRight);
+	}
+
+	static inline void replaceChild(Node *parentNode, Node *oldChild, Node *newChild)
+	{
+		if (parentNode->getLeft() == oldChild)
+			parentNode->setLeft(newChild);
+		else
+			parentNode->setRight(newChild);
+	}
+
+	Node *rotateRightLocked(
+		Node *parentNode,
+		Node *node,
+		Node *nodeLeft,
+		const int heightRight,
+		const int heightLeftLeft,
+		Node *nodeLeftRight,
+		const int heightLeftRight)
+	{
+		const uint64_t nodeVersion = node->getVersion();
+		node->setVersion(Node::beginShrink(nodeVersion));
+
+		// fix up links, the order keeps the tree traversable for everything but node
+		node->setLeft(nodeLeftRight);
+		if (nodeLeftRight != nullptr)
+			nodeLeftRight->setParent(node);
+
+		nodeLeft->setRight(node);
+		node->setParent(nodeLeft);
+
+		replaceChild(parentNode, node, nodeLeft);
+		nodeLeft->setParent(parentNode);
+
+		// fix up heights
+		const int newHeightNode = 1 + std::max(heightLeftRight, heightRight);
+		node->setHeight(newHeightNode);
+		nodeLeft->setHeight(1 + std::max(heightLeftLeft, newHeightNode));
+
+		node->setVersion(Node::endShrink(nodeVersion));
+
+		// parentNode, node and nodeLeft are damaged now, fix as much as possible with the locks we hold
+		const int balanceNode = heightLeftRight - heightRight;
+		if (balanceNode < -1 || balanceNode > 1)
+			return node;
+
+		// node might be a routing node that can be unlinked now
+		if ((nodeLeftRight == nullptr || heightRight == 0) && !node->isPresent())
+			return node;
+
+		const int balanceLeft = heightLeftLeft - newHeightNode;
+		if (balanceLeft < -1 || balanceLeft > 1)
+			return nodeLeft;
+
+		if (heightLeftLeft == 0 && !nodeLeft->isPresent())
+			return nodeLeft;
+
+		return fixHeightLocked(parentNode);
+	}
+
+	Node *rotateLeftLocked(
+		Node *parentNode,
+		Node *node,
+		const int heightLeft,
+		Node *nodeRight,
+		Node *nodeRightLeft,
+		const int heightRightLeft,
+		const int heightRightRight)
+	{
+		const uint64_t nodeVersion = node->getVersion();
+		node->setVersion(Node::beginShrink(nodeVersion));
+
+		node->setRight(nodeRightLeft);
+		if (nodeRightLeft != nullptr)
+			nodeRightLeft->setParent(node);
+
+		nodeRight->setLeft(node);
+		node->setParent(nodeRight);
+
+		replaceChild(parentNode, node, nodeRight);
+		nodeRight->setParent(parentNode);
+
+		const int newHeightNode = 1 + std::max(heightLeft, heightRightLeft);
+		node->setHeight(newHeightNode);
+		nodeRight->setHeight(1 + std::max(newHeightNode, heightRightRight));
+
+		node->setVersion(Node::endShrink(nodeVersion));
+
+		const int balanceNode = heightRightLeft - heightLeft;
+		if (balanceNode < -1 || balanceNode > 1)
+			return node;
+
+		if ((nodeRightLeft == nullptr || heightLeft == 0) && !node->isPresent())
+			return node;
+
+		const int balanceRight = heightRightRight - newHeightNode;
+		if (balanceRight < -1 || balanceRight > 1)
+			return nodeRight;
+
+		if (heightRightRight == 0 && !nodeRight->isPresent())
+			return nodeRight;
+
+		return fixHeightLocked(parentNode);
+	}
+
+	Node *rotateRightOverLeftLocked(
+		Node *parentNode,
+		Node *node,
+		Node *nodeLeft,
+		const int heightRight,
+		const int heightLeftLeft,
+		Node *nodeLeftRight,
+		const int heightLeftRightLeft)
+	{
+		const uint64_t nodeVersion = node->getVersion();
+		const uint64_t leftVersion = nodeLeft->getVersion();
+
+		Node *nodeLeftRightLeft = nodeLeftRight->getLeft();
+		Node *nodeLeftRightRight = nodeLeftRight->getRight();
+		const int heightLeftRightRight = height(nodeLeftRightRight);
+
+		// node and nodeLeft both lose keys, nodeLeftRight only gains keys
+		node->setVersion(Node::beginShrink(nodeVersion));
+		nodeLeft->setVersion(Node::beginShrink(leftVersion));
+
+		node->setLeft(nodeLeftRightRight);
+		if (nodeLeftRightRight != nullptr)
+			nodeLeftRightRight->setParent(node);
+
+		nodeLeft->setRight(nodeLeftRightLeft);
+		if (nodeLeftRightLeft != nullptr)
+			nodeLeftRightLeft->setParent(nodeLeft);
+
+		nodeLeftRight->setLeft(nodeLeft);
+		nodeLeft->setParent(nodeLeftRight);
+		nodeLeftRight->setRight(node);
+		node->setParent(nodeLeftRight);
+
+		replaceChild(parentNode, node, nodeLeftRight);
+		nodeLeftRight->setParent(parentNode);
+
+		const int newHeightNode = 1 + std::max(heightLeftRightRight, heightRight);
+		node->setHeight(newHeightNode);
+		const int newHeightLeft = 1 + std::max(heightLeftLeft, heightLeftRightLeft);
+		nodeLeft->setHeight(newHeightLeft);
+		nodeLeftRight->setHeight(1 + std::max(newHeightLeft, newHeightNode));
+
+		node->setVersion(Node::endShrink(nodeVersion));
+		nodeLeft->setVersion(Node::endShrink(leftVersion));
+
+		const int balanceNode = heightLeftRightRight - heightRight;
+		if (balanceNode < -1 || balanceNode > 1)
+			return node;
+
+		if ((nodeLeftRightRight == nullptr || heightRight == 0) && !node->isPresent())
+			return node;
+
+		const int balanceLeftRight = newHeightLeft - newHeightNode;
+		if (balanceLeftRight < -1 || balanceLeftRight > 1)
+			return nodeLeftRight;
+
+		return fixHeightLocked(parentNode);
+	}
+
+	Node *rotateLeftOverRightLocked(
+		Node *parentNode,
+		Node *node,
+		const int heightLeft,
+		Node *nodeRight,
+		Node *nodeRightLeft,
+		const int heightRightRight,
+		const int heightRightLeftRight)
+	{
+		const uint64_t nodeVersion = node->getVersion();
+		const uint64_t rightVersion = nodeRight->getVersion();
+
+		Node *nodeRightLeftLeft = nodeRightLeft->getLeft();
+		Node *nodeRightLeftRight = nodeRightLeft->getRight();
+		const int heightRightLeftLeft = height(nodeRightLeftLeft);
+
+		node->setVersion(Node::beginShrink(nodeVersion));
+		nodeRight->setVersion(Node::beginShrink(rightVersion));
+
+		node->setRight(nodeRightLeftLeft);
+		if (nodeRightLeftLeft != nullptr)
+			nodeRightLeftLeft->setParent(node);
+
+		nodeRight->setLeft(nodeRightLeftRight);
+		if (nodeRightLeftRight != nullptr)
+			nodeRightLeftRight->setParent(nodeRight);
+
+		nodeRightLeft->setRight(nodeRight);
+		nodeRight->setParent(nodeRightLeft);
+		nodeRightLeft->setLeft(node);
+		node->setParent(nodeRightLeft);
+
+		replaceChild(parentNode, node, nodeRightLeft);
+		nodeRightLeft->setParent(parentNode);
+
+		const int newHeightNode = 1 + std::max(heightLeft, heightRightLeftLeft);
+		node->setHeight(newHeightNode);
+		const int newHeightRight = 1 + std::max(heightRightLeftRight, heightRightRight);
+		nodeRight->setHeight(newHeightRight);
+		nodeRightLeft->setHeight(1 + std::max(newHeightNode, newHeightRight));
+
+		node->setVersion(Node::endShrink(nodeVersion));
+		nodeRight->setVersion(Node::endShrink(rightVersion));
+
+		const int balanceNode = heightRightLeftLeft - heightLeft;
+		if (balanceNode < -1 || balanceNode > 1)
+			return node;
+
+		if ((nodeRightLeftLeft == nullptr || heightLeft == 0) && !node->isPresent())
+			return node;
+
+		const int balanceRightLeft = newHeightRight - newHeightNode;
+		if (balanceRightLeft < -1 || balanceRightLeft > 1)
+			return nodeRightLeft;
+
+		return fixHeightLocked(parentNode);
+	}
+
+private:
+	Node *rootHolder; // sentinel whose right child is the actual root of the tree
+	mutable EpochReclamation reclamation; // unlinked nodes, also pinned by the readers of containsNode
+};
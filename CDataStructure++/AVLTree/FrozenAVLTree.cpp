@@ -0,0 +1 @@
+#include <FrozenAVLTree.h>
\ No newline at end of file
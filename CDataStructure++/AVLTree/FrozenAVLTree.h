@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+/*
+ * Immutable search structure created by AVLTree::freeze().
+ *
+ * The data is stored contiguously in Eytzinger (BFS) order: the children of index k are at 2k and 2k + 1 and
+ * index 0 is unused. The top levels of the tree share a few cache lines and the search has no unpredictable
+ * branches, while the 16 (for int) descendants four levels below the current index are contiguous and can be
+ * prefetched ahead of time. Compared to following heap-scattered AVLNodes this avoids most cache misses.
+ */
+template <typename T>
+class FrozenAVLTree
+{
+public:
+	FrozenAVLTree() = default;
+
+	/*
+	 *	sortedData has to be sorted ascending and must not contain duplicates.
+	 */
+	explicit FrozenAVLTree(const std::vector<const T *> &sortedData)
+	{
+		if (sortedData.empty())
+			return;
+
+		// compute for every Eytzinger index which sorted element it holds, then copy the data in index order
+		std::vector<size_t> sortedIdx(sortedData.size() + 1);
+		size_t nextSortedIdx = 0;
+		assignInorder(sortedIdx, nextSortedIdx, 1);
+
+		data.reserve(sortedData.size() + 1);
+		data.push_back(*sortedData.front()); // placeholder for the unused index 0
+		for (size_t k = 1; k <= sortedData.size(); ++k)
+		{
+			data.push_back(*sortedData[sortedIdx[k]]);
+		}
+	}
+
+	/*
+	 *	Returns the smallest element that is not less than data, or nullptr if there is none.
+	 */
+	const T *lower_bound(const T &key) const
+	{
+		const size_t k = lowerBoundIdx(key);
+		return k == 0 ? nullptr : &data[k];
+	}
+
+	/*
+	 *	Returns the element equal to data, or nullptr if there is none.
+	 */
+	const T *searchNode(const T &key) const
+	{
+		const T *found = lower_bound(key);
+		if (found != nullptr && !(key < *found))
+			return found;
+		return nullptr;
+	}
+
+	size_t getSize() const
+	{
+		return data.empty() ? 0 : data.size() - 1;
+	}
+
+private:
+	// amount of elements in a cache line, rounded down to a power of 2 so that it is a whole number of levels
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+	static constexpr size_t elementsPerCacheLine()
+	{
+		size_t elements = 1;
+		while (elements * 2 * sizeof(T) <= CACHE_LINE_SIZE)
+			elements *= 2;
+		return elements;
+	}
+	static constexpr size_t PREFETCH_STRIDE = elementsPerCacheLine();
+
+	// walks the implicit tree in-order, the i-th visited index holds the i-th smallest element
+	void assignInorder(std::vector<size_t> &sortedIdx, size_t &nextSortedIdx, const size_t k) const
+	{
+		if (k < sortedIdx.size())
+		{
+			assignInorder(sortedIdx, nextSortedIdx, 2 * k);
+			sortedIdx[k] = nextSortedIdx++;
+			assignInorder(sortedIdx, nextSortedIdx, 2 * k + 1);
+		}
+	}
+
+	size_t lowerBoundIdx(const T &key) const
+	{
+		const size_t size = getSize();
+		const T *base = data.data();
+		size_t k = 1;
+		while (k <= size)
+		{
+			prefetch(base + k * PREFETCH_STRIDE);
+			// go right if the element is smaller than the key, compiles to a conditional move instead of a branch
+			k = 2 * k + static_cast<size_t>(base[k] < key);
+		}
+		// k encodes the path taken, every right turn is a 1 bit. The lower bound is where the search
+		// turned left for the last time, so strip the trailing right turns and that left turn.
+		return k >> (countTrailingOnes(k) + 1);
+	}
+
+	static inline void prefetch(const T *address)
+	{
+		// prefetching beyond the end of the array is harmless, prefetches never fault
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(address);
+#elif defined(_MSC_VER)
+		_mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0);
+#endif
+	}
+
+	static inline unsigned countTrailingOnes(const size_t value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(value)));
+#else
+		unsigned count = 0;
+		for (size_t v = value; v & 1; v >>= 1)
+			++count;
+		return count;
+#endif
+	}
+
+private:
+	std::vector<T> data; // Eytzinger order, index 0 is unused
+};
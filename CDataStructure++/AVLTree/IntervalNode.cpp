@@ -0,0 +1 @@
+#include <IntervalNode.h>
\ No newline at end of file
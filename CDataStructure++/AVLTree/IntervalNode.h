@@ -0,0 +1,140 @@
+#pragma once
+#include <ostream>
+
+// Closed interval [lo, hi], ordered by lo and then by hi
+template <typename T>
+struct Interval
+{
+	T lo;
+	T hi;
+
+	inline bool overlaps(const T &otherLo, const T &otherHi) const
+	{
+		return !(hi < otherLo) && !(otherHi < lo);
+	}
+
+	inline bool operator<(const Interval &other) const
+	{
+		return lo < other.lo || (!(other.lo < lo) && hi < other.hi);
+	}
+
+	inline bool operator>(const Interval &other) const
+	{
+		return other < *this;
+	}
+
+	inline bool operator==(const Interval &other) const
+	{
+		return !(*this < other) && !(other < *this);
+	}
+};
+
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const Interval<T> &interval)
+{
+	return os << "[" << interval.lo << ", " << interval.hi << "]";
+}
+
+/*
+ * Node of the IntervalTree. Same interface as AVLNode so that it can be rebalanced by AVLTree, which calls
+ * updateFromChildren() bottom-up on every node whose subtree changed, including the nodes of a rotation.
+ * maxHi is the largest hi of all intervals in the subtree of the node.
+ */
+template <typename T>
+class IntervalNode
+{
+public:
+	explicit IntervalNode(
+		IntervalNode *parent,
+		const Interval<T> &interval)
+		: interval(interval),
+		  maxHi(interval.hi),
+		  left(nullptr),
+		  right(nullptr),
+		  parent(parent),
+		  bf(0)
+	{
+	}
+
+	inline void updateFromChildren()
+	{
+		maxHi = interval.hi;
+		if (left != nullptr && maxHi < left->maxHi)
+			maxHi = left->maxHi;
+		if (right != nullptr && maxHi < right->maxHi)
+			maxHi = right->maxHi;
+	}
+
+	inline const Interval<T> &getData() const
+	{
+		return interval;
+	}
+
+	inline const T &getMaxHi() const
+	{
+		return maxHi;
+	}
+
+	inline const signed char getBf() const
+	{
+		return bf;
+	}
+
+	inline void setBf(const signed char newBf)
+	{
+		this->bf = newBf;
+	}
+
+	inline void setLeft(IntervalNode *newLeft)
+	{
+		this->left = newLeft;
+	}
+
+	inline void setRight(IntervalNode *newRight)
+	{
+		this->right = newRight;
+	}
+
+	inline void setParent(IntervalNode *newParent)
+	{
+		this->parent = newParent;
+	}
+
+	inline bool hasLeft() const
+	{
+		return left != nullptr;
+	}
+
+	inline bool hasRight() const
+	{
+		return right != nullptr;
+	}
+
+	inline bool hasParent() const
+	{
+		return parent != nullptr;
+	}
+
+	inline IntervalNode *getLeft()
+	{
+		return left;
+	}
+
+	inline IntervalNode *getRight()
+	{
+		return right;
+	}
+
+	inline IntervalNode *getParent()
+	{
+		return parent;
+	}
+
+private:
+	const Interval<T> interval; // interval the tree is ordered by
+	T maxHi;					// largest hi in the subtree
+	IntervalNode *left;			// pointer to left node
+	IntervalNode *right;		// pointer to right node
+	IntervalNode *parent;		// pointer to parent node
+	signed char bf;				// balance factor of current node
+};
@@ -0,0 +1 @@
+#include <IntervalTree.h>
\ No newline at end of file
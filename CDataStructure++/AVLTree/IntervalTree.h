@@ -0,0 +1,103 @@
+#pragma once
+#include <AVLTree.h>
+#include <IntervalNode.h>
+#include <vector>
+
+/*
+ * Set of closed intervals on top of the AVLTree rebalancing, ordered by their lower endpoint.
+ * Every node knows the largest upper endpoint in its subtree, so overlap queries skip every subtree that ends
+ * before the query starts and every right subtree that starts after the query ends.
+ */
+template <typename T>
+class IntervalTree
+{
+public:
+	using Node = IntervalNode<T>;
+
+public:
+	IntervalTree() = default;
+
+	// Delete constructors which may cause headache and bugs
+	IntervalTree(const IntervalTree &) = delete;
+	IntervalTree(IntervalTree &&) = delete;
+
+	/*
+	 *	Insert the interval [lo, hi]. Returns false if the same interval is already present.
+	 */
+	bool insertNode(const T &lo, const T &hi)
+	{
+		const Interval<T> interval{lo, hi};
+		return tree.emplaceNode(interval, interval).second;
+	}
+
+	/*
+	 *	Remove the interval [lo, hi]. Returns false if it does not exist.
+	 */
+	bool removeNode(const T &lo, const T &hi)
+	{
+		return tree.removeNode(Interval<T>{lo, hi});
+	}
+
+	Node *searchNode(const T &lo, const T &hi)
+	{
+		return tree.searchNode(Interval<T>{lo, hi});
+	}
+
+	/*
+	 *	Calls visitor(interval) for every interval overlapping [lo, hi] in ascending order.
+	 */
+	template <typename Visitor>
+	void findOverlapping(const T &lo, const T &hi, Visitor &&visitor)
+	{
+		findOverlapping(tree.getRoot(), lo, hi, visitor);
+	}
+
+	std::vector<Interval<T>> findOverlapping(const T &lo, const T &hi)
+	{
+		std::vector<Interval<T>> overlapping;
+		findOverlapping(lo, hi, [&overlapping](const Interval<T> &interval)
+						{ overlapping.push_back(interval); });
+		return overlapping;
+	}
+
+	/*
+	 *	Returns all intervals containing point.
+	 */
+	std::vector<Interval<T>> stabbingQuery(const T &point)
+	{
+		return findOverlapping(point, point);
+	}
+
+	Node *getRoot()
+	{
+		return tree.getRoot();
+	}
+
+	void printTree()
+	{
+		tree.printTree();
+	}
+
+private:
+	template <typename Visitor>
+	void findOverlapping(Node *currNode, const T &lo, const T &hi, Visitor &visitor)
+	{
+		// no interval in this subtree reaches lo
+		if (currNode == nullptr || currNode->getMaxHi() < lo)
+			return;
+
+		findOverlapping(currNode->getLeft(), lo, hi, visitor);
+
+		// the intervals in the right subtree start at or after this one, so none of them can reach back to hi
+		if (hi < currNode->getData().lo)
+			return;
+
+		if (currNode->getData().overlaps(lo, hi))
+			visitor(currNode->getData());
+
+		findOverlapping(currNode->getRight(), lo, hi, visitor);
+	}
+
+private:
+	AVLTree<Interval<T>, Node> tree;
+};
@@ -0,0 +1 @@
+#include <PersistentAVLNode.h>
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+
+/*
+ * Immutable node of the PersistentAVLTree. Nodes are shared between versions of the tree and reference counted,
+ * a node is freed as soon as no version (snapshot) of the tree refers to it anymore.
+ * Since nodes are shared there is no parent pointer and the node stores the height of its subtree instead of
+ * the balance factor, which makes it possible to rebalance bottom-up while copying the search path.
+ */
+template <typename T>
+class PersistentAVLNode
+{
+public:
+	using NodePtr = std::shared_ptr<const PersistentAVLNode>;
+
+	explicit PersistentAVLNode(
+		const T &data,
+		NodePtr left,
+		NodePtr right)
+		: data(data),
+		  left(std::move(left)),
+		  right(std::move(right)),
+		  height(1 + std::max(heightOf(this->left), heightOf(this->right)))
+	{
+	}
+
+	static inline int heightOf(const NodePtr &node)
+	{
+		return node == nullptr ? 0 : node->getHeight();
+	}
+
+	inline const T &getData() const
+	{
+		return data;
+	}
+
+	inline int getHeight() const
+	{
+		return height;
+	}
+
+	inline signed char getBf() const
+	{
+		return static_cast<signed char>(heightOf(right) - heightOf(left));
+	}
+
+	inline bool hasLeft() const
+	{
+		return left != nullptr;
+	}
+
+	inline bool hasRight() const
+	{
+		return right != nullptr;
+	}
+
+	inline const NodePtr &getLeft() const
+	{
+		return left;
+	}
+
+	inline const NodePtr &getRight() const
+	{
+		return right;
+	}
+
+private:
+	const T data;		 // data present in the node
+	const NodePtr left;	 // pointer to left node
+	const NodePtr right; // pointer to right node
+	const int height;	 // height of the subtree rooted at this node
+};
@@ -0,0 +1 @@
+#include <PersistentAVLTree.h>
\ No newline at end of file
@@ -0,0 +1,270 @@
+#pragma once
+#include <PersistentAVLNode.h>
+#include <Trace.h>
+#include <iostream>
+#include <memory>
+#include <string>
+
+/*
+ * Persistent (path-copying) AVL tree.
+ *
+ * insertNode/removeNode never modify existing nodes. They copy the O(log n) nodes on the search path, rebalance
+ * the copies and publish the new root. Every older root stays a valid, immutable version of the tree, so taking
+ * a snapshot is O(1): it just shares the current root. Nodes are reference counted and freed when the last
+ * version referring to them is gone.
+ *
+ * The root is published atomically, readers can take snapshots while writers continue. Concurrent writers are
+ * serialized by a compare-and-swap on the root and retry their path copy if another writer was faster.
+ */
+template <typename T>
+class PersistentAVLTree
+{
+public:
+	using Node = PersistentAVLNode<T>;
+	using NodePtr = typename Node::NodePtr;
+
+public:
+	PersistentAVLTree()
+		: root(nullptr)
+	{
+	}
+
+	PersistentAVLTree(const T &data)
+		: root(std::make_shared<const Node>(data, nullptr, nullptr))
+	{
+	}
+
+	// Copying shares all nodes, the copy is a point-in-time snapshot of the other tree
+	PersistentAVLTree(const PersistentAVLTree<T> &other)
+		: root(other.getRoot())
+	{
+	}
+
+	PersistentAVLTree<T> &operator=(const PersistentAVLTree<T> &other)
+	{
+		std::atomic_store(&root, other.getRoot());
+		return *this;
+	}
+
+	/*
+	 *	Consistent point-in-time view of the tree, unaffected by later insertions or removals.
+	 */
+	PersistentAVLTree<T> snapshot() const
+	{
+		return PersistentAVLTree<T>(*this);
+	}
+
+	void insertNode(const T &data)
+	{
+		TRACE_SCOPE("PersistentAVLTree::insertNode");
+		NodePtr oldRoot = getRoot();
+		NodePtr newRoot;
+		do
+		{
+			bool changed = false;
+			newRoot = insertNode(data, oldRoot, changed);
+			if (!changed)
+				return; // don't add a node with the same data value twice
+		} while (!std::atomic_compare_exchange_weak(&root, &oldRoot, newRoot));
+	}
+
+	/*
+	 *	Remove node with given data. Older versions of the tree keep the node.
+	 */
+	void removeNode(const T &data)
+	{
+		TRACE_SCOPE("PersistentAVLTree::removeNode");
+		NodePtr oldRoot = getRoot();
+		NodePtr newRoot;
+		do
+		{
+			bool changed = false;
+			newRoot = removeNode(data, oldRoot, changed);
+			if (!changed)
+				return; // nothing to remove
+		} while (!std::atomic_compare_exchange_weak(&root, &oldRoot, newRoot));
+	}
+
+	/*
+	 *	The returned node stays valid as long as the caller holds on to the pointer, even if the node is
+	 *	removed from the tree in the meantime.
+	 */
+	NodePtr searchNode(const T &data) const
+	{
+		NodePtr currNode = getRoot();
+		while (currNode != nullptr)
+		{
+			if (data < currNode->getData())
+			{
+				currNode = currNode->getLeft();
+			}
+			else if (data > currNode->getData())
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				return currNode;
+			}
+		}
+		return nullptr;
+	}
+
+	NodePtr getRoot() const
+	{
+		return std::atomic_load(&root);
+	}
+
+	void printTree() const
+	{
+		std::cout << "Printing the Persistent AVL Tree\n";
+		std::cout << "|-- = left node (value < parent value)\n";
+		std::cout << "\\-- = right/root node (value > parent value)\n\n";
+		printTree("", getRoot(), false);
+	}
+
+private:
+	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
+	void printTree(const std::string &prefix, const NodePtr &node, bool isLeft) const
+	{
+		if (node != nullptr)
+		{
+			std::cout << prefix;
+
+			std::cout << (isLeft ? "|-- " : "\\-- ");
+
+			// print the value of the node
+			std::cout << "(" << node->getData() << ", bf: " << (int)node->getBf() << ")" << std::endl;
+
+			// enter the next tree level - left and right branch
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		}
+	}
+
+	static inline NodePtr makeNode(const T &data, NodePtr left, NodePtr right)
+	{
+		return std::make_shared<const Node>(data, std::move(left), std::move(right));
+	}
+
+	/*
+	 * Creates a new node out of data and the two given subtrees, which may differ in height by at most 2.
+	 * If they differ by 2 the node is rebuilt with a single or double rotation. Only the nodes taking part in
+	 * the rotation are created anew, all subtrees below them are shared.
+	 */
+	static NodePtr balance(const T &data, NodePtr left, NodePtr right)
+	{
+		const int bf = Node::heightOf(right) - Node::heightOf(left);
+
+		if (bf > 1)
+		{
+			if (Node::heightOf(right->getRight()) >= Node::heightOf(right->getLeft()))
+			{
+				// Right Right - rotate left
+				return makeNode(right->getData(),
+								makeNode(data, std::move(left), right->getLeft()),
+								right->getRight());
+			}
+			// Right Left - rotate right around right child and then left
+			const NodePtr &innerChild = right->getLeft();
+			return makeNode(innerChild->getData(),
+							makeNode(data, std::move(left), innerChild->getLeft()),
+							makeNode(right->getData(), innerChild->getRight(), right->getRight()));
+		}
+
+		if (bf < -1)
+		{
+			if (Node::heightOf(left->getLeft()) >= Node::heightOf(left->getRight()))
+			{
+				// Left Left - rotate right
+				return makeNode(left->getData(),
+								left->getLeft(),
+								makeNode(data, left->getRight(), std::move(right)));
+			}
+			// Left Right - rotate left around left child and then right
+			const NodePtr &innerChild = left->getRight();
+			return makeNode(innerChild->getData(),
+							makeNode(left->getData(), left->getLeft(), innerChild->getLeft()),
+							makeNode(data, innerChild->getRight(), std::move(right)));
+		}
+
+		return makeNode(data, std::move(left), std::move(right));
+	}
+
+	NodePtr insertNode(const T &data, const NodePtr &currNode, bool &changed) const
+	{
+		if (currNode == nullptr)
+		{
+			changed = true;
+			return makeNode(data, nullptr, nullptr);
+		}
+
+		if (data < currNode->getData())
+		{
+			NodePtr newLeft = insertNode(data, currNode->getLeft(), changed);
+			if (!changed)
+				return currNode;
+			return balance(currNode->getData(), std::move(newLeft), currNode->getRight());
+		}
+		else if (data > currNode->getData())
+		{
+			NodePtr newRight = insertNode(data, currNode->getRight(), changed);
+			if (!changed)
+				return currNode;
+			return balance(currNode->getData(), currNode->getLeft(), std::move(newRight));
+		}
+
+		return currNode;
+	}
+
+	// removes the smallest node of the subtree and stores its data in minData
+	NodePtr removeMinNode(const NodePtr &currNode, const T *&minData) const
+	{
+		if (!currNode->hasLeft())
+		{
+			minData = &currNode->getData();
+			return currNode->getRight();
+		}
+		NodePtr newLeft = removeMinNode(currNode->getLeft(), minData);
+		return balance(currNode->getData(), std::move(newLeft), currNode->getRight());
+	}
+
+	NodePtr removeNode(const T &data, const NodePtr &currNode, bool &changed) const
+	{
+		if (currNode == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (data < currNode->getData())
+		{
+			NodePtr newLeft = removeNode(data, currNode->getLeft(), changed);
+			if (!changed)
+				return currNode;
+			return balance(currNode->getData(), std::move(newLeft), currNode->getRight());
+		}
+		else if (data > currNode->getData())
+		{
+			NodePtr newRight = removeNode(data, currNode->getRight(), changed);
+			if (!changed)
+				return currNode;
+			return balance(currNode->getData(), currNode->getLeft(), std::move(newRight));
+		}
+
+		changed = true;
+
+		if (!currNode->hasLeft())
+			return currNode->getRight();
+		if (!currNode->hasRight())
+			return currNode->getLeft();
+
+		// both children: the inorder successor takes the place of the removed node. The old successor node
+		// is still referenced by currNode (and thus kept alive) while its data is copied.
+		const T *successorData = nullptr;
+		NodePtr newRight = removeMinNode(currNode->getRight(), successorData);
+		return balance(*successorData, currNode->getLeft(), std::move(newRight));
+	}
+
+private:
+	NodePtr root; // only accessed through std::atomic_load/std::atomic_store
+};
@@ -0,0 +1 @@
+#include <BPlusTree.h>
\ No newline at end of file
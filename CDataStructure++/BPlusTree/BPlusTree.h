@@ -0,0 +1,569 @@
+#pragma once
+#include "BPlusTreeNode.h"
+#include <Trace.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// keys of a node fill 4 cache lines, rounded down to a whole amount of 8 SIMD lanes
+template <typename K>
+constexpr size_t BPlusTreeDefaultCapacity()
+{
+	return (256 / sizeof(K)) / 8 * 8 < 8 ? 8 : (256 / sizeof(K)) / 8 * 8;
+}
+
+/*
+ * B+tree with wide nodes as cache-friendly alternative to AVLTree and BinarySearchTree for large ordered indexes.
+ * A lookup touches one node per level, and with 64 int keys per node the tree is about 6x less deep than a
+ * binary tree. All values are stored in the leaves, which are linked for range scans.
+ *
+ * The search inside a node compares 8 (32 bit keys) or 4 (64 bit keys) keys at once with AVX2 if the code is
+ * compiled with AVX2 enabled (cmake -DENABLE_AVX2=ON) and the keys are signed integers. Otherwise a binary
+ * search is used.
+ */
+template <typename K, typename V, size_t Capacity = BPlusTreeDefaultCapacity<K>()>
+class BPlusTree
+{
+	static_assert(Capacity >= 8 && Capacity % 8 == 0, "Capacity must be a multiple of the SIMD width");
+
+public:
+	using Node = BPlusTreeNode<K, Capacity>;
+	using InnerNode = BPlusTreeInnerNode<K, Capacity>;
+	using LeafNode = BPlusTreeLeafNode<K, V, Capacity>;
+
+public:
+	BPlusTree()
+		: root(nullptr),
+		  size(0)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	BPlusTree(const BPlusTree &) = delete;
+	BPlusTree(BPlusTree &&) = delete;
+
+	~BPlusTree()
+	{
+		cleanUpTree(root);
+	}
+
+	/*
+	 *	Insert key with value. Returns false if the key already exists, the old value is kept.
+	 */
+	bool insertNode(const K &key, const V &value)
+	{
+		if (root == nullptr)
+		{
+			root = new LeafNode();
+		}
+
+		// Nodes are split on the way down, so that there is always room in the parent for the new separator
+		if (root->getCount() == Capacity)
+		{
+			InnerNode *newRoot = new InnerNode();
+			newRoot->setChild(0, root);
+			splitChild(newRoot, 0);
+			root = newRoot;
+		}
+
+		Node *currNode = root;
+		while (!currNode->isLeaf())
+		{
+			InnerNode *innerNode = static_cast<InnerNode *>(currNode);
+			size_t idx = upperBound(innerNode, key);
+			if (innerNode->getChild(idx)->getCount() == Capacity)
+			{
+				splitChild(innerNode, idx);
+				if (!(key < innerNode->getKey(idx)))
+				{
+					++idx;
+				}
+			}
+			currNode = innerNode->getChild(idx);
+		}
+
+		LeafNode *leaf = static_cast<LeafNode *>(currNode);
+		const size_t pos = lowerBound(leaf, key);
+		if (pos < leaf->getCount() && !(key < leaf->getKey(pos)))
+		{
+			return false;
+		}
+
+		for (size_t i = leaf->getCount(); i > pos; --i)
+		{
+			leaf->getKey(i) = std::move(leaf->getKey(i - 1));
+			leaf->getValue(i) = std::move(leaf->getValue(i - 1));
+		}
+		leaf->getKey(pos) = key;
+		leaf->getValue(pos) = value;
+		leaf->setCount(leaf->getCount() + 1);
+		++size;
+		return true;
+	}
+
+	/*
+	 *	Returns the value of key or nullptr if the key does not exist.
+	 */
+	V *searchNode(const K &key)
+	{
+		if (root == nullptr)
+			return nullptr;
+
+		LeafNode *leaf = findLeaf(key);
+		const size_t pos = lowerBound(leaf, key);
+		if (pos < leaf->getCount() && !(key < leaf->getKey(pos)))
+		{
+			return &leaf->getValue(pos);
+		}
+		return nullptr;
+	}
+
+	/*
+	 *	Remove key and its value. Returns false if the key does not exist.
+	 */
+	bool removeNode(const K &key)
+	{
+		if (root == nullptr || !removeNode(root, key))
+			return false;
+
+		--size;
+
+		// the root is the only node that may underflow, it is removed once it is empty
+		if (root->getCount() == 0)
+		{
+			Node *oldRoot = root;
+			root = root->isLeaf() ? nullptr : static_cast<InnerNode *>(oldRoot)->getChild(0);
+			deleteNode(oldRoot);
+		}
+		return true;
+	}
+
+	/*
+	 *	Calls visitor(key, value) for every key in [lo, hi] in ascending order. Only the first leaf is searched
+	 *	from the root, afterwards the linked leaves are followed.
+	 */
+	template <typename Visitor>
+	void rangeScan(const K &lo, const K &hi, Visitor &&visitor)
+	{
+		TRACE_SCOPE("BPlusTree::rangeScan");
+		if (root == nullptr)
+			return;
+
+		LeafNode *leaf = findLeaf(lo);
+		size_t pos = lowerBound(leaf, lo);
+		while (leaf != nullptr)
+		{
+			for (; pos < leaf->getCount(); ++pos)
+			{
+				if (hi < leaf->getKey(pos))
+					return;
+				visitor(leaf->getKey(pos), leaf->getValue(pos));
+			}
+			leaf = leaf->getNext();
+			pos = 0;
+		}
+	}
+
+	size_t getSize() const
+	{
+		return size;
+	}
+
+	size_t getHeight() const
+	{
+		size_t height = 0;
+		for (Node *currNode = root; currNode != nullptr; ++height)
+		{
+			currNode = currNode->isLeaf() ? nullptr : static_cast<InnerNode *>(currNode)->getChild(0);
+		}
+		return height;
+	}
+
+private:
+	// a split leaves Capacity / 2 keys in a leaf and (Capacity - 1) / 2 in an inner node
+	static constexpr size_t MIN_LEAF_KEYS = Capacity / 2;
+	static constexpr size_t MIN_INNER_KEYS = (Capacity - 1) / 2;
+
+	static inline size_t minKeys(const Node *node)
+	{
+		return node->isLeaf() ? MIN_LEAF_KEYS : MIN_INNER_KEYS;
+	}
+
+	static constexpr bool USE_SIMD_SEARCH = std::is_integral<K>::value && std::is_signed<K>::value &&
+											(sizeof(K) == 4 || sizeof(K) == 8);
+
+	// index of the first key that is not less than key
+	static inline size_t lowerBound(const Node *node, const K &key)
+	{
+#if defined(__AVX2__)
+		if constexpr (USE_SIMD_SEARCH)
+		{
+			return simdCountKeys<false>(node->getKeys(), node->getCount(), key);
+		}
+#endif
+		const K *keys = node->getKeys();
+		return std::lower_bound(keys, keys + node->getCount(), key) - keys;
+	}
+
+	// index of the first key that is greater than key, which is the index of the child to descend into
+	static inline size_t upperBound(const Node *node, const K &key)
+	{
+#if defined(__AVX2__)
+		if constexpr (USE_SIMD_SEARCH)
+		{
+			return node->getCount() - simdCountKeys<true>(node->getKeys(), node->getCount(), key);
+		}
+#endif
+		const K *keys = node->getKeys();
+		return std::upper_bound(keys, keys + node->getCount(), key) - keys;
+	}
+
+#if defined(__AVX2__)
+	/*
+	 * Counts the keys greater than key (CountGreater) or less than key (!CountGreater) among the first count keys.
+	 * All keys of the node are compared without branches, the lanes past count are masked out. Loading whole
+	 * vectors never reads past the key array since Capacity is a multiple of 8.
+	 */
+	template <bool CountGreater>
+	static inline size_t simdCountKeys(const K *keys, const size_t count, const K &key)
+	{
+		size_t result = 0;
+		if constexpr (sizeof(K) == 4)
+		{
+			const __m256i keyVector = _mm256_set1_epi32(static_cast<int32_t>(key));
+			for (size_t i = 0; i < count; i += 8)
+			{
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+				const __m256i cmp = CountGreater ? _mm256_cmpgt_epi32(block, keyVector) : _mm256_cmpgt_epi32(keyVector, block);
+				unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+				if (count - i < 8)
+				{
+					mask &= (1u << (count - i)) - 1;
+				}
+				result += popCount(mask);
+			}
+		}
+		else
+		{
+			const __m256i keyVector = _mm256_set1_epi64x(static_cast<int64_t>(key));
+			for (size_t i = 0; i < count; i += 4)
+			{
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+				const __m256i cmp = CountGreater ? _mm256_cmpgt_epi64(block, keyVector) : _mm256_cmpgt_epi64(keyVector, block);
+				unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)));
+				if (count - i < 4)
+				{
+					mask &= (1u << (count - i)) - 1;
+				}
+				result += popCount(mask);
+			}
+		}
+		return result;
+	}
+
+	static inline size_t popCount(const unsigned mask)
+	{
+#if defined(_MSC_VER)
+		return __popcnt(mask);
+#else
+		return static_cast<size_t>(__builtin_popcount(mask));
+#endif
+	}
+#endif
+
+	LeafNode *findLeaf(const K &key) const
+	{
+		Node *currNode = root;
+		while (!currNode->isLeaf())
+		{
+			InnerNode *innerNode = static_cast<InnerNode *>(currNode);
+			currNode = innerNode->getChild(upperBound(innerNode, key));
+		}
+		return static_cast<LeafNode *>(currNode);
+	}
+
+	// inserts separator at idx and newChild at idx + 1 into a parent that is not full
+	static void insertIntoInner(InnerNode *parent, const size_t idx, const K &separator, Node *newChild)
+	{
+		for (size_t i = parent->getCount(); i > idx; --i)
+		{
+			parent->getKey(i) = std::move(parent->getKey(i - 1));
+			parent->setChild(i + 1, parent->getChild(i));
+		}
+		parent->getKey(idx) = separator;
+		parent->setChild(idx + 1, newChild);
+		parent->setCount(parent->getCount() + 1);
+	}
+
+	// removes the key at idx and the child at idx + 1 from parent
+	static void removeFromInner(InnerNode *parent, const size_t idx)
+	{
+		for (size_t i = idx; i + 1 < parent->getCount(); ++i)
+		{
+			parent->getKey(i) = std::move(parent->getKey(i + 1));
+			parent->setChild(i + 1, parent->getChild(i + 2));
+		}
+		parent->setCount(parent->getCount() - 1);
+	}
+
+	// splits the full child at idx of parent in two halves
+	void splitChild(InnerNode *parent, const size_t idx)
+	{
+		TRACE_SCOPE("BPlusTree::splitChild");
+		Node *child = parent->getChild(idx);
+		const size_t mid = Capacity / 2;
+
+		if (child->isLeaf())
+		{
+			// leaves keep all keys, the first key of the right leaf is copied up as separator
+			LeafNode *leftLeaf = static_cast<LeafNode *>(child);
+			LeafNode *rightLeaf = new LeafNode();
+			for (size_t i = mid; i < Capacity; ++i)
+			{
+				rightLeaf->getKey(i - mid) = std::move(leftLeaf->getKey(i));
+				rightLeaf->getValue(i - mid) = std::move(leftLeaf->getValue(i));
+			}
+			rightLeaf->setCount(Capacity - mid);
+			leftLeaf->setCount(mid);
+			rightLeaf->setNext(leftLeaf->getNext());
+			leftLeaf->setNext(rightLeaf);
+			insertIntoInner(parent, idx, rightLeaf->getKey(0), rightLeaf);
+		}
+		else
+		{
+			// the middle key of an inner node moves up to the parent
+			InnerNode *leftInner = static_cast<InnerNode *>(child);
+			InnerNode *rightInner = new InnerNode();
+			for (size_t i = mid + 1; i < Capacity; ++i)
+			{
+				rightInner->getKey(i - mid - 1) = std::move(leftInner->getKey(i));
+			}
+			for (size_t i = mid + 1; i <= Capacity; ++i)
+			{
+				rightInner->setChild(i - mid - 1, leftInner->getChild(i));
+			}
+			rightInner->setCount(Capacity - mid - 1);
+			leftInner->setCount(mid);
+			insertIntoInner(parent, idx, leftInner->getKey(mid), rightInner);
+		}
+	}
+
+	bool removeNode(Node *currNode, const K &key)
+	{
+		if (currNode->isLeaf())
+		{
+			LeafNode *leaf = static_cast<LeafNode *>(currNode);
+			const size_t pos = lowerBound(leaf, key);
+			if (pos == leaf->getCount() || key < leaf->getKey(pos))
+			{
+				return false;
+			}
+			for (size_t i = pos; i + 1 < leaf->getCount(); ++i)
+			{
+				leaf->getKey(i) = std::move(leaf->getKey(i + 1));
+				leaf->getValue(i) = std::move(leaf->getValue(i + 1));
+			}
+			leaf->setCount(leaf->getCount() - 1);
+			return true;
+		}
+
+		// separators of removed keys may stay in inner nodes, they still route correctly
+		InnerNode *innerNode = static_cast<InnerNode *>(currNode);
+		const size_t idx = upperBound(innerNode, key);
+		if (!removeNode(innerNode->getChild(idx), key))
+		{
+			return false;
+		}
+
+		Node *child = innerNode->getChild(idx);
+		if (child->getCount() < minKeys(child))
+		{
+			fixUnderflow(innerNode, idx);
+		}
+		return true;
+	}
+
+	// The child at idx has one key too few: borrow a key from a sibling if it can spare one, otherwise merge
+	// with a sibling. A non-root inner node always has at least one key, so there is always a sibling.
+	void fixUnderflow(InnerNode *parent, const size_t idx)
+	{
+		Node *leftSibling = idx > 0 ? parent->getChild(idx - 1) : nullptr;
+		Node *rightSibling = idx < parent->getCount() ? parent->getChild(idx + 1) : nullptr;
+
+		if (leftSibling != nullptr && leftSibling->getCount() > minKeys(leftSibling))
+		{
+			borrowFromLeft(parent, idx);
+		}
+		else if (rightSibling != nullptr && rightSibling->getCount() > minKeys(rightSibling))
+		{
+			borrowFromRight(parent, idx);
+		}
+		else if (rightSibling != nullptr)
+		{
+			mergeChildren(parent, idx);
+		}
+		else
+		{
+			mergeChildren(parent, idx - 1);
+		}
+	}
+
+	void borrowFromLeft(InnerNode *parent, const size_t idx)
+	{
+		Node *child = parent->getChild(idx);
+		Node *leftSibling = parent->getChild(idx - 1);
+		const size_t leftCount = leftSibling->getCount();
+
+		for (size_t i = child->getCount(); i > 0; --i)
+		{
+			child->getKey(i) = std::move(child->getKey(i - 1));
+		}
+
+		if (child->isLeaf())
+		{
+			LeafNode *leaf = static_cast<LeafNode *>(child);
+			LeafNode *leftLeaf = static_cast<LeafNode *>(leftSibling);
+			for (size_t i = leaf->getCount(); i > 0; --i)
+			{
+				leaf->getValue(i) = std::move(leaf->getValue(i - 1));
+			}
+			leaf->getKey(0) = std::move(leftLeaf->getKey(leftCount - 1));
+			leaf->getValue(0) = std::move(leftLeaf->getValue(leftCount - 1));
+			parent->getKey(idx - 1) = leaf->getKey(0);
+		}
+		else
+		{
+			// the separator moves down into the child and the last key of the sibling moves up
+			InnerNode *innerNode = static_cast<InnerNode *>(child);
+			InnerNode *leftInner = static_cast<InnerNode *>(leftSibling);
+			for (size_t i = innerNode->getCount() + 1; i > 0; --i)
+			{
+				innerNode->setChild(i, innerNode->getChild(i - 1));
+			}
+			innerNode->getKey(0) = std::move(parent->getKey(idx - 1));
+			innerNode->setChild(0, leftInner->getChild(leftCount));
+			parent->getKey(idx - 1) = std::move(leftInner->getKey(leftCount - 1));
+		}
+
+		leftSibling->setCount(leftCount - 1);
+		child->setCount(child->getCount() + 1);
+	}
+
+	void borrowFromRight(InnerNode *parent, const size_t idx)
+	{
+		Node *child = parent->getChild(idx);
+		Node *rightSibling = parent->getChild(idx + 1);
+		const size_t count = child->getCount();
+		const size_t rightCount = rightSibling->getCount();
+
+		if (child->isLeaf())
+		{
+			LeafNode *leaf = static_cast<LeafNode *>(child);
+			LeafNode *rightLeaf = static_cast<LeafNode *>(rightSibling);
+			leaf->getKey(count) = std::move(rightLeaf->getKey(0));
+			leaf->getValue(count) = std::move(rightLeaf->getValue(0));
+			for (size_t i = 0; i + 1 < rightCount; ++i)
+			{
+				rightLeaf->getKey(i) = std::move(rightLeaf->getKey(i + 1));
+				rightLeaf->getValue(i) = std::move(rightLeaf->getValue(i + 1));
+			}
+			parent->getKey(idx) = rightLeaf->getKey(0);
+		}
+		else
+		{
+			// the separator moves down into the child and the first key of the sibling moves up
+			InnerNode *innerNode = static_cast<InnerNode *>(child);
+			InnerNode *rightInner = static_cast<InnerNode *>(rightSibling);
+			innerNode->getKey(count) = std::move(parent->getKey(idx));
+			innerNode->setChild(count + 1, rightInner->getChild(0));
+			parent->getKey(idx) = std::move(rightInner->getKey(0));
+			for (size_t i = 0; i + 1 < rightCount; ++i)
+			{
+				rightInner->getKey(i) = std::move(rightInner->getKey(i + 1));
+			}
+			for (size_t i = 0; i < rightCount; ++i)
+			{
+				rightInner->setChild(i, rightInner->getChild(i + 1));
+			}
+		}
+
+		rightSibling->setCount(rightCount - 1);
+		child->setCount(count + 1);
+	}
+
+	// merges the child at idx + 1 into the child at idx
+	void mergeChildren(InnerNode *parent, const size_t idx)
+	{
+		TRACE_SCOPE("BPlusTree::mergeChildren");
+		Node *leftChild = parent->getChild(idx);
+		Node *rightChild = parent->getChild(idx + 1);
+		size_t count = leftChild->getCount();
+
+		if (leftChild->isLeaf())
+		{
+			LeafNode *leftLeaf = static_cast<LeafNode *>(leftChild);
+			LeafNode *rightLeaf = static_cast<LeafNode *>(rightChild);
+			for (size_t i = 0; i < rightLeaf->getCount(); ++i, ++count)
+			{
+				leftLeaf->getKey(count) = std::move(rightLeaf->getKey(i));
+				leftLeaf->getValue(count) = std::move(rightLeaf->getValue(i));
+			}
+			leftLeaf->setNext(rightLeaf->getNext());
+		}
+		else
+		{
+			// the separator of both children moves down between their keys
+			InnerNode *leftInner = static_cast<InnerNode *>(leftChild);
+			InnerNode *rightInner = static_cast<InnerNode *>(rightChild);
+			leftInner->getKey(count++) = std::move(parent->getKey(idx));
+			for (size_t i = 0; i < rightInner->getCount(); ++i)
+			{
+				leftInner->getKey(count + i) = std::move(rightInner->getKey(i));
+			}
+			for (size_t i = 0; i <= rightInner->getCount(); ++i)
+			{
+				leftInner->setChild(count + i, rightInner->getChild(i));
+			}
+			count += rightInner->getCount();
+		}
+
+		leftChild->setCount(count);
+		removeFromInner(parent, idx);
+		deleteNode(rightChild);
+	}
+
+	// nodes have no virtual destructor, delete them with their actual type
+	static void deleteNode(Node *node)
+	{
+		if (node->isLeaf())
+			delete static_cast<LeafNode *>(node);
+		else
+			delete static_cast<InnerNode *>(node);
+	}
+
+	void cleanUpTree(Node *currNode)
+	{
+		// Post-order traversal to delete and free up memory taken by each node.
+		if (currNode != nullptr)
+		{
+			if (!currNode->isLeaf())
+			{
+				InnerNode *innerNode = static_cast<InnerNode *>(currNode);
+				for (size_t i = 0; i <= innerNode->getCount(); ++i)
+				{
+					cleanUpTree(innerNode->getChild(i));
+				}
+			}
+			deleteNode(currNode);
+		}
+	}
+
+private:
+	Node *root;
+	size_t size; // amount of keys stored
+};
@@ -0,0 +1 @@
+#include <BPlusTreeNode.h>
\ No newline at end of file
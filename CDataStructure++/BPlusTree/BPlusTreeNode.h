@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Nodes of the BPlusTree. Inner nodes and leaves share the layout of the key array so that the in-node search
+ * works the same on both. Inner nodes only route: the key at index i is the smallest key reachable through
+ * child i + 1. Leaves hold the values and are linked to the next leaf for range scans.
+ *
+ * Capacity is a multiple of the SIMD width so that the in-node search can always load whole vectors.
+ */
+template <typename K, size_t Capacity>
+class BPlusTreeNode
+{
+public:
+	explicit BPlusTreeNode(const bool leaf)
+		: leaf(leaf),
+		  count(0),
+		  keys()
+	{
+	}
+
+	inline bool isLeaf() const
+	{
+		return leaf;
+	}
+
+	inline size_t getCount() const
+	{
+		return count;
+	}
+
+	inline void setCount(const size_t newCount)
+	{
+		count = static_cast<uint32_t>(newCount);
+	}
+
+	inline const K *getKeys() const
+	{
+		return keys;
+	}
+
+	inline K &getKey(const size_t idx)
+	{
+		return keys[idx];
+	}
+
+	inline const K &getKey(const size_t idx) const
+	{
+		return keys[idx];
+	}
+
+private:
+	const bool leaf; // leaves hold values, inner nodes hold children
+	uint32_t count;	 // amount of keys used
+
+protected:
+	K keys[Capacity]; // sorted keys, only the first count are valid
+};
+
+template <typename K, size_t Capacity>
+class BPlusTreeInnerNode : public BPlusTreeNode<K, Capacity>
+{
+public:
+	BPlusTreeInnerNode()
+		: BPlusTreeNode<K, Capacity>(false),
+		  children()
+	{
+	}
+
+	inline BPlusTreeNode<K, Capacity> *getChild(const size_t idx) const
+	{
+		return children[idx];
+	}
+
+	inline void setChild(const size_t idx, BPlusTreeNode<K, Capacity> *newChild)
+	{
+		children[idx] = newChild;
+	}
+
+private:
+	BPlusTreeNode<K, Capacity> *children[Capacity + 1]; // one more child than keys
+};
+
+template <typename K, typename V, size_t Capacity>
+class BPlusTreeLeafNode : public BPlusTreeNode<K, Capacity>
+{
+public:
+	BPlusTreeLeafNode()
+		: BPlusTreeNode<K, Capacity>(true),
+		  values(),
+		  next(nullptr)
+	{
+	}
+
+	inline V &getValue(const size_t idx)
+	{
+		return values[idx];
+	}
+
+	inline BPlusTreeLeafNode *getNext() const
+	{
+		return next;
+	}
+
+	inline void setNext(BPlusTreeLeafNode *newNext)
+	{
+		next = newNext;
+	}
+
+private:
+	V values[Capacity];		 // value of the key with the same index
+	BPlusTreeLeafNode *next; // leaf with the next larger keys, nullptr for the last leaf
+};
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <future>
 #include <iostream>
 #include <tuple>
+#include <vector>
+#include <TreeFile.h>
+#include <MemoryUsage.h>
+#include <TeardownQueue.h>
+#include <Trace.h>
 #include "BinarySearchTreeNode.h"
 
 template<typename T>
@@ -22,7 +31,9 @@ public:
 
 	BinarySearchTree(const T& data)
 		:
-		root(new BinarySearchTreeNode<T>(data))
+		root(new BinarySearchTreeNode<T>(data)),
+		nodeCount(1),
+		maxNodeCount(1)
 	{
 	}
 
@@ -35,6 +46,33 @@ public:
 		cleanUpTree(root);
 	}
 
+	/*
+	* Deletes all nodes, iteratively and in O(n).
+	*/
+	void clear()
+	{
+		TRACE_SCOPE("BinarySearchTree::clear");
+		cleanUpTree(root);
+		root = nullptr;
+		nodeCount = 0;
+		maxNodeCount = 0;
+	}
+
+	/*
+	* Detaches all nodes in O(1) and deletes them on the TeardownQueue thread, the tree is empty and usable right
+	* away. The returned future is ready once every node is freed, it can be dropped without waiting: the
+	* TeardownQueue finishes before the program exits.
+	*/
+	std::future<void> clearDeferred()
+	{
+		BinarySearchTreeNode<T>* oldRoot = root;
+		root = nullptr;
+		nodeCount = 0;
+		maxNodeCount = 0;
+
+		return TeardownQueue::enqueue([oldRoot]() { cleanUpTree(oldRoot); });
+	}
+
 	void printTree(BinarySearchTreeNode<T>* node = nullptr)
 	{
 		std::cout << "Printing the BST\n";
@@ -173,6 +211,13 @@ public:
 			}
 			
 			currNode = nullptr;
+			--nodeCount;
+
+			// in scapegoat mode, the whole tree is rebuilt once enough nodes were removed since the last rebuild
+			if (scapegoatAlpha > 0 && nodeCount < scapegoatAlpha * maxNodeCount)
+			{
+				rebalance();
+			}
 		}
 	}
 
@@ -187,12 +232,21 @@ public:
 		if (root == nullptr)
 		{
 			root = new BinarySearchTreeNode<T>(data);
+			nodeCount = 1;
+			maxNodeCount = std::max<size_t>(maxNodeCount, 1);
 		}
 		else
 		{
+			insertionPath.clear();
 			BinarySearchTreeNode<T>* currNode = root;
 			while (currNode != nullptr)
 			{
+				// the path is only needed to find a scapegoat
+				if (scapegoatAlpha > 0)
+				{
+					insertionPath.push_back(currNode);
+				}
+
 				if (data < currNode->getData())
 				{
 					if (currNode->hasLeft())
@@ -202,6 +256,8 @@ public:
 					else
 					{
 						currNode->setLeft(new BinarySearchTreeNode<T>(data));
+						++nodeCount;
+						rebuildIfTooDeep(currNode->getLeft());
 						return;
 					}						
 				}
@@ -214,6 +270,8 @@ public:
 					else
 					{
 						currNode->setRight(new BinarySearchTreeNode<T>(data));
+						++nodeCount;
+						rebuildIfTooDeep(currNode->getRight());
 						return;
 					}
 				}
@@ -226,6 +284,80 @@ public:
 		}
 	}
 
+	/*
+	* Day-Stout-Warren: rebuilds the tree into perfect balance (all levels full except the lowest) in O(n) time and
+	* O(1) extra space. The tree is first rotated into a sorted right-leaning list (the vine) and then folded
+	* back up by left rotations on every second node of the vine. Existing nodes are relinked, none are copied.
+	*/
+	void rebalance()
+	{
+		TRACE_SCOPE("BinarySearchTree::rebalance");
+		root = rebuildBalanced(root);
+		maxNodeCount = nodeCount;
+	}
+
+	/*
+	* Scapegoat mode keeps the tree balanced without any data in the nodes: when an insertion ends deeper than
+	* log(n) / log(1 / alpha), the lowest ancestor whose child on the path holds more than alpha of its nodes
+	* is rebuilt with rebalance(). Once the size drops below alpha times the size at the last full rebuild,
+	* the whole tree is rebuilt. alpha has to be in (0.5, 1): lower values keep the tree flatter but rebuild
+	* more often. Enabling it rebalances the tree once, disabling keeps the current shape.
+	*/
+	void setScapegoatMode(const bool enabled, const double alpha = DEFAULT_SCAPEGOAT_ALPHA)
+	{
+		scapegoatAlpha = enabled ? alpha : 0;
+		if (enabled)
+		{
+			rebalance();
+		}
+	}
+
+	BinarySearchTreeNode<T>* getRoot()
+	{
+		return root;
+	}
+
+	size_t getSize() const
+	{
+		return nodeCount;
+	}
+
+	/*
+	* Heap memory of the nodes, one allocation per element. Memory that T itself allocates isn't included.
+	*/
+	MemoryUsage memoryUsage() const
+	{
+		MemoryUsage usage;
+		usage.allocations = nodeCount;
+		usage.bytesLive = nodeCount * sizeof(BinarySearchTreeNode<T>);
+		usage.elements = nodeCount;
+		return usage;
+	}
+
+	/*
+	* Ordered lookup: follows a single path down from the root, O(height) instead of visiting every node like DFS.
+	*/
+	BinarySearchTreeNode<T>* find(const T& data)
+	{
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (data < currNode->getData())
+			{
+				currNode = currNode->getLeft();
+			}
+			else if (data > currNode->getData())
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				return currNode;
+			}
+		}
+		return nullptr;
+	}
+
 	BinarySearchTreeNode<T>* DFS(const T& data, BinarySearchTreeNode<T>* currRoot)
 	{
 		if (currRoot != nullptr)
@@ -256,6 +388,144 @@ public:
 		return DFS(data, root);
 	}
 
+	/*
+	* Visitor traversals: visitor(data) is called for every node in the given order. They use Morris threading, so
+	* there is no recursion and no heap, only O(1) extra memory, at the price of walking every edge about twice.
+	* While one runs, the tree is temporarily threaded through unused right links, so the visitor must not change
+	* the tree or throw, and no other thread may read the tree at the same time.
+	*/
+	template<typename Visitor>
+	void forEachInOrder(Visitor&& visitor)
+	{
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (!currNode->hasLeft())
+			{
+				visitor(currNode->getData());
+				currNode = currNode->getRight();
+				continue;
+			}
+
+			BinarySearchTreeNode<T>* predecessorNode = findThreadablePredecessor(currNode);
+			if (predecessorNode->getRight() == nullptr)
+			{
+				// first visit: thread the predecessor back to currNode and go left
+				predecessorNode->setRight(currNode);
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				// came back over the thread: the left subtree is done
+				predecessorNode->setRight(nullptr);
+				visitor(currNode->getData());
+				currNode = currNode->getRight();
+			}
+		}
+	}
+
+	template<typename Visitor>
+	void forEachPreOrder(Visitor&& visitor)
+	{
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (!currNode->hasLeft())
+			{
+				visitor(currNode->getData());
+				currNode = currNode->getRight();
+				continue;
+			}
+
+			BinarySearchTreeNode<T>* predecessorNode = findThreadablePredecessor(currNode);
+			if (predecessorNode->getRight() == nullptr)
+			{
+				visitor(currNode->getData());
+				predecessorNode->setRight(currNode);
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				predecessorNode->setRight(nullptr);
+				currNode = currNode->getRight();
+			}
+		}
+	}
+
+	template<typename Visitor>
+	void forEachPostOrder(Visitor&& visitor)
+	{
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (!currNode->hasLeft())
+			{
+				currNode = currNode->getRight();
+				continue;
+			}
+
+			BinarySearchTreeNode<T>* predecessorNode = findThreadablePredecessor(currNode);
+			if (predecessorNode->getRight() == nullptr)
+			{
+				predecessorNode->setRight(currNode);
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				// the left subtree is done except for its right spine, which comes bottom-up in post-order
+				predecessorNode->setRight(nullptr);
+				visitRightSpineReversed(currNode->getLeft(), visitor);
+				currNode = currNode->getRight();
+			}
+		}
+		visitRightSpineReversed(root, visitor);
+	}
+
+	/*
+	* Writes the tree in the TreeFile format, which can be loaded again by deserialize or searched in place
+	* by MappedTree. T has to be trivially copyable.
+	*/
+	bool serialize(std::ostream& out)
+	{
+		TRACE_SCOPE("BinarySearchTree::serialize");
+		return writeTreeFile<T>(out, root, 0, [](BinarySearchTreeNode<T>*) { return 0; });
+	}
+
+	/*
+	* Replaces the tree by the tree written by serialize (or AVLTree::serialize) in O(n) with the same shape.
+	* Returns false and keeps the tree if in holds no search tree of T with ordered data.
+	*/
+	bool deserialize(std::istream& in)
+	{
+		TRACE_SCOPE("BinarySearchTree::deserialize");
+		std::vector<TreeFileNode<T>> records;
+		if (!readTreeFile(in, records))
+			return false;
+
+		std::vector<BinarySearchTreeNode<T>*> nodes(records.size());
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			nodes[i] = new BinarySearchTreeNode<T>(records[i].data);
+		}
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			if (records[i].hasLeft())
+				nodes[i]->setLeft(nodes[i + 1]);
+			if (records[i].hasRight())
+				nodes[i]->setRight(nodes[records[i].right]);
+		}
+
+		cleanUpTree(root);
+		root = nodes.empty() ? nullptr : nodes.front();
+		nodeCount = nodes.size();
+		maxNodeCount = nodeCount;
+		if (scapegoatAlpha > 0)
+		{
+			rebalance();
+		}
+		return true;
+	}
+
 private:
 	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
 	void printTree(const std::string& prefix, BinarySearchTreeNode<T>* node, bool isLeft)
@@ -313,28 +583,178 @@ private:
 		}
 	}
 	
-	void cleanUpTree(BinarySearchTreeNode<T>* currNode)
+	void rebuildIfTooDeep(BinarySearchTreeNode<T>* newNode)
 	{
-		// Post-order traversal to delete and free up memory taken by each node.
-		// First the left three and right tree are visited and deleted first and then the current node is deleted so 
-		// that everything descendent node is deleted first before deleting the current node to not lose reference
-		// and cause memory leaks.
-		if (currNode != nullptr)
+		maxNodeCount = std::max(maxNodeCount, nodeCount);
+		if (scapegoatAlpha <= 0 || insertionPath.size() <= std::log(static_cast<double>(nodeCount)) / -std::log(scapegoatAlpha))
 		{
-			if (currNode->hasLeft())
+			return;
+		}
+
+		// walk back up the path: a node that is too deep always has an ancestor that is out of alpha balance
+		BinarySearchTreeNode<T>* childNode = newNode;
+		size_t childSize = 1;
+		for (size_t i = insertionPath.size(); i-- > 0;)
+		{
+			BinarySearchTreeNode<T>* ancestorNode = insertionPath[i];
+			BinarySearchTreeNode<T>* siblingNode = ancestorNode->getLeft() == childNode ? ancestorNode->getRight() : ancestorNode->getLeft();
+			const size_t ancestorSize = childSize + subtreeSize(siblingNode) + 1;
+			if (childSize > scapegoatAlpha * ancestorSize)
 			{
-				cleanUpTree(currNode->getLeft());
+				BinarySearchTreeNode<T>* parentNode = i == 0 ? nullptr : insertionPath[i - 1];
+				BinarySearchTreeNode<T>* rebuiltNode = rebuildBalanced(ancestorNode);
+				if (parentNode == nullptr)
+				{
+					root = rebuiltNode;
+				}
+				else
+				{
+					setChildFromParent(parentNode, ancestorNode, rebuiltNode);
+				}
+				return;
 			}
+			childNode = ancestorNode;
+			childSize = ancestorSize;
+		}
+	}
 
-			if (currNode->hasRight())
+	size_t subtreeSize(BinarySearchTreeNode<T>* currNode)
+	{
+		if (currNode == nullptr)
+		{
+			return 0;
+		}
+		return 1 + subtreeSize(currNode->getLeft()) + subtreeSize(currNode->getRight());
+	}
+
+	// DSW on the subtree of subtreeRoot, returns the new root of the subtree
+	BinarySearchTreeNode<T>* rebuildBalanced(BinarySearchTreeNode<T>* subtreeRoot)
+	{
+		TRACE_SCOPE("BinarySearchTree::rebuildBalanced");
+		// tree to vine: rotate right until no node has a left child
+		BinarySearchTreeNode<T>* vineHead = nullptr;
+		BinarySearchTreeNode<T>* vineTail = nullptr;
+		BinarySearchTreeNode<T>* currNode = subtreeRoot;
+		size_t size = 0;
+		while (currNode != nullptr)
+		{
+			if (currNode->hasLeft())
+			{
+				BinarySearchTreeNode<T>* leftNode = currNode->getLeft();
+				currNode->setLeft(leftNode->getRight());
+				leftNode->setRight(currNode);
+				currNode = leftNode;
+			}
+			else
 			{
-				cleanUpTree(currNode->getRight());
+				if (vineTail == nullptr)
+					vineHead = currNode;
+				else
+					vineTail->setRight(currNode);
+				vineTail = currNode;
+				currNode = currNode->getRight();
+				++size;
 			}
+		}
+
+		// vine to tree: first the nodes of the incomplete lowest level, then halve the vine until it is one node
+		size_t fullSize = 1;
+		while (fullSize * 2 <= size + 1)
+		{
+			fullSize *= 2;
+		}
+		vineHead = compressVine(vineHead, size + 1 - fullSize);
+		for (size_t vineSize = fullSize - 1; vineSize > 1; vineSize /= 2)
+		{
+			vineHead = compressVine(vineHead, vineSize / 2);
+		}
+		return vineHead;
+	}
+
+	// left-rotates the first count odd nodes of the vine around their right child, returns the new head
+	BinarySearchTreeNode<T>* compressVine(BinarySearchTreeNode<T>* vineHead, const size_t count)
+	{
+		BinarySearchTreeNode<T>* scannerNode = nullptr;
+		for (size_t i = 0; i < count; ++i)
+		{
+			BinarySearchTreeNode<T>* childNode = scannerNode == nullptr ? vineHead : scannerNode->getRight();
+			BinarySearchTreeNode<T>* grandChildNode = childNode->getRight();
+			childNode->setRight(grandChildNode->getLeft());
+			grandChildNode->setLeft(childNode);
+			if (scannerNode == nullptr)
+				vineHead = grandChildNode;
+			else
+				scannerNode->setRight(grandChildNode);
+			scannerNode = grandChildNode;
+		}
+		return vineHead;
+	}
+
+	// rightmost node of the left subtree of currNode, or the one whose right link is already threaded to currNode
+	static BinarySearchTreeNode<T>* findThreadablePredecessor(BinarySearchTreeNode<T>* currNode)
+	{
+		BinarySearchTreeNode<T>* predecessorNode = currNode->getLeft();
+		while (predecessorNode->getRight() != nullptr && predecessorNode->getRight() != currNode)
+		{
+			predecessorNode = predecessorNode->getRight();
+		}
+		return predecessorNode;
+	}
+
+	// reverses the right links of the spine starting at currNode and returns its former last node
+	static BinarySearchTreeNode<T>* reverseRightSpine(BinarySearchTreeNode<T>* currNode)
+	{
+		BinarySearchTreeNode<T>* previousNode = nullptr;
+		while (currNode != nullptr)
+		{
+			BinarySearchTreeNode<T>* nextNode = currNode->getRight();
+			currNode->setRight(previousNode);
+			previousNode = currNode;
+			currNode = nextNode;
+		}
+		return previousNode;
+	}
+
+	// visits the right spine starting at spineHead from the bottom up, reversing it in place and back again
+	template<typename Visitor>
+	static void visitRightSpineReversed(BinarySearchTreeNode<T>* spineHead, Visitor& visitor)
+	{
+		BinarySearchTreeNode<T>* spineTail = reverseRightSpine(spineHead);
+		for (BinarySearchTreeNode<T>* currNode = spineTail; currNode != nullptr; currNode = currNode->getRight())
+		{
+			visitor(currNode->getData());
+		}
+		reverseRightSpine(spineTail);
+	}
 
-			delete currNode;
+	static void cleanUpTree(BinarySearchTreeNode<T>* currNode)
+	{
+		// rotate left children up until currNode has none, then it can be deleted without recursing, so even a
+		// degenerate tree is freed in O(n) without any extra memory
+		while (currNode != nullptr)
+		{
+			if (currNode->hasLeft())
+			{
+				BinarySearchTreeNode<T>* leftNode = currNode->getLeft();
+				currNode->setLeft(leftNode->getRight());
+				leftNode->setRight(currNode);
+				currNode = leftNode;
+			}
+			else
+			{
+				BinarySearchTreeNode<T>* rightNode = currNode->getRight();
+				delete currNode;
+				currNode = rightNode;
+			}
 		}
 	}
 
 private:
+	static constexpr double DEFAULT_SCAPEGOAT_ALPHA = 0.7;
+
 	BinarySearchTreeNode<T>* root;
+	size_t nodeCount = 0;
+	size_t maxNodeCount = 0;	// largest nodeCount since the last full rebuild, used by scapegoat mode
+	double scapegoatAlpha = 0;	// 0 if scapegoat mode is off
+	std::vector<BinarySearchTreeNode<T>*> insertionPath; // ancestors of the inserted node, kept to reuse its memory
 };
\ No newline at end of file
@@ -0,0 +1 @@
+#include <ConcurrentBST.h>
\ No newline at end of file
@@ -0,0 +1,242 @@
+#pragma once
+#include <ConcurrentBSTNode.h>
+#include <EpochReclamation.h>
+#include <Trace.h>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+ * Lock-free ordered set following "Fast Concurrent Lock-Free Binary Search Trees" (Natarajan and Mittal, PPoPP
+ * 2014). The tree is external (leaf-oriented): the data is in the leaves and internal nodes only route.
+ *
+ *	- containsNode walks down once without writing anything or retrying, so it is wait-free.
+ *	- insertNode replaces a leaf by a new internal node with the old and the new leaf, a single CAS on one edge.
+ *	- removeNode first flags the edge to the leaf (the removal is decided then), then tags the edge to the
+ *	  sibling so it can't change anymore and swings the edge above the parent to the sibling, which unlinks
+ *	  the parent and the leaf. Threads that run into a flagged or tagged edge help to finish that removal
+ *	  instead of waiting for it.
+ *
+ * Unlinked nodes are retired to an EpochReclamation and freed once no operation can still be reading them.
+ * T has to be default constructible for the sentinel nodes.
+ */
+template <typename T>
+class ConcurrentBST
+{
+public:
+	using Node = ConcurrentBSTNode<T>;
+
+public:
+	ConcurrentBST()
+	{
+		// three sentinel leaves larger than all data keep every real leaf below two internal nodes, so a
+		// removal always finds an ancestor and a successor:  rootNode(inf2) -> sentinelNode(inf1) -> data
+		Node *sentinelNode = new Node(T(), INFINITY_1, new Node(T(), INFINITY_0), new Node(T(), INFINITY_1));
+		rootNode = new Node(T(), INFINITY_2, sentinelNode, new Node(T(), INFINITY_2));
+	}
+
+	// Delete constructors which may cause headache and bugs
+	ConcurrentBST(const ConcurrentBST<T> &) = delete;
+	ConcurrentBST(ConcurrentBST<T> &&) = delete;
+
+	~ConcurrentBST()
+	{
+		// no other thread may use the tree anymore, free everything still reachable, the reclamation frees the rest
+		std::vector<Node *> toDelete = {rootNode};
+		while (!toDelete.empty())
+		{
+			Node *currNode = toDelete.back();
+			toDelete.pop_back();
+			if (!currNode->isLeaf())
+			{
+				toDelete.push_back(Node::getAddress(currNode->getLeftEdge().load()));
+				toDelete.push_back(Node::getAddress(currNode->getRightEdge().load()));
+			}
+			delete currNode;
+		}
+	}
+
+	/*
+	 *	Returns true if the data is present in the tree. Wait-free.
+	 */
+	bool containsNode(const T &data)
+	{
+		EpochReclamation::Guard guard(reclamation);
+		SeekRecord seekRecord;
+		seek(data, seekRecord);
+		return seekRecord.leaf->holds(data);
+	}
+
+	/*
+	 *	Insert given data. Returns false if the data was already present. Lock-free.
+	 */
+	bool insertNode(const T &data)
+	{
+		EpochReclamation::Guard guard(reclamation);
+		SeekRecord seekRecord;
+		while (true)
+		{
+			seek(data, seekRecord);
+			Node *leaf = seekRecord.leaf;
+			if (leaf->holds(data))
+				return false;
+
+			// the new internal node routes between the old leaf and the new one
+			Node *newLeaf = new Node(data);
+			Node *newInternal = leaf->isLeftOf(data)
+									? new Node(leaf->getData(), leaf->getInfinity(), newLeaf, leaf)
+									: new Node(data, 0, leaf, newLeaf);
+
+			std::atomic<uintptr_t> &childEdge = getChildEdge(seekRecord.parent, data);
+			uintptr_t expected = Node::toEdge(leaf);
+			if (childEdge.compare_exchange_strong(expected, Node::toEdge(newInternal), std::memory_order_acq_rel))
+				return true;
+
+			// never published, nobody else can have seen them
+			delete newLeaf;
+			delete newInternal;
+
+			// the edge is blocked by a removal at this position, help to finish it before retrying
+			if (Node::getAddress(expected) == leaf && (Node::isFlagged(expected) || Node::isTagged(expected)))
+				cleanup(data, seekRecord, guard);
+		}
+	}
+
+	/*
+	 *	Remove node with given data. Returns false if the data was not present. Lock-free.
+	 */
+	bool removeNode(const T &data)
+	{
+		EpochReclamation::Guard guard(reclamation);
+		SeekRecord seekRecord;
+		Node *leaf = nullptr;
+		bool injected = false;
+		while (true)
+		{
+			seek(data, seekRecord);
+			if (!injected)
+			{
+				// injection: flag the edge to the leaf, after that no other thread can insert next to it
+				leaf = seekRecord.leaf;
+				if (!leaf->holds(data))
+					return false;
+
+				std::atomic<uintptr_t> &childEdge = getChildEdge(seekRecord.parent, data);
+				uintptr_t expected = Node::toEdge(leaf);
+				if (childEdge.compare_exchange_strong(expected, Node::toEdge(leaf, Node::FLAG), std::memory_order_acq_rel))
+				{
+					injected = true;
+					if (cleanup(data, seekRecord, guard))
+						return true;
+				}
+				else if (Node::getAddress(expected) == leaf && (Node::isFlagged(expected) || Node::isTagged(expected)))
+				{
+					cleanup(data, seekRecord, guard);
+				}
+			}
+			else
+			{
+				// the removal is decided, only the unlinking is left, unless another thread already did it
+				if (seekRecord.leaf != leaf)
+					return true;
+				if (cleanup(data, seekRecord, guard))
+					return true;
+			}
+		}
+	}
+
+private:
+	static constexpr unsigned char INFINITY_0 = 1;
+	static constexpr unsigned char INFINITY_1 = 2;
+	static constexpr unsigned char INFINITY_2 = 3;
+
+	/*
+	 *	Result of a seek: the leaf data ends at, its parent, and the last untagged edge on the way (ancestor to
+	 *	successor). Every edge between successor and parent is tagged, so the whole chain is unlinked together.
+	 */
+	struct SeekRecord
+	{
+		Node *ancestor;
+		Node *successor;
+		Node *parent;
+		Node *leaf;
+	};
+
+	static inline std::atomic<uintptr_t> &getChildEdge(Node *parentNode, const T &data)
+	{
+		return parentNode->isLeftOf(data) ? parentNode->getLeftEdge() : parentNode->getRightEdge();
+	}
+
+	void seek(const T &data, SeekRecord &seekRecord)
+	{
+		Node *sentinelNode = Node::getAddress(rootNode->getLeftEdge().load(std::memory_order_acquire));
+		seekRecord.ancestor = rootNode;
+		seekRecord.successor = sentinelNode;
+		seekRecord.parent = sentinelNode;
+
+		uintptr_t parentEdge = sentinelNode->getLeftEdge().load(std::memory_order_acquire);
+		seekRecord.leaf = Node::getAddress(parentEdge);
+		uintptr_t currentEdge = seekRecord.leaf->getLeftEdge().load(std::memory_order_acquire);
+		Node *currNode = Node::getAddress(currentEdge);
+		while (currNode != nullptr)
+		{
+			if (!Node::isTagged(parentEdge))
+			{
+				seekRecord.ancestor = seekRecord.parent;
+				seekRecord.successor = seekRecord.leaf;
+			}
+			seekRecord.parent = seekRecord.leaf;
+			seekRecord.leaf = currNode;
+			parentEdge = currentEdge;
+			currentEdge = getChildEdge(currNode, data).load(std::memory_order_acquire);
+			currNode = Node::getAddress(currentEdge);
+		}
+	}
+
+	/*
+	 *	Unlinks the flagged leaf below seekRecord.parent (and every node of the tagged chain above it) by swinging
+	 *	the edge from ancestor to successor to the sibling of that leaf. Returns false if the edge changed.
+	 */
+	bool cleanup(const T &data, const SeekRecord &seekRecord, EpochReclamation::Guard &guard)
+	{
+		TRACE_SCOPE("ConcurrentBST::cleanup");
+		Node *ancestorNode = seekRecord.ancestor;
+		Node *successorNode = seekRecord.successor;
+		Node *parentNode = seekRecord.parent;
+		std::atomic<uintptr_t> &successorEdge = getChildEdge(ancestorNode, data);
+
+		std::atomic<uintptr_t> *childEdge = &parentNode->getLeftEdge();
+		std::atomic<uintptr_t> *siblingEdge = &parentNode->getRightEdge();
+		if (!parentNode->isLeftOf(data))
+			std::swap(childEdge, siblingEdge);
+		// the flagged leaf can be on either side: this removal's leaf or one that blocked an insert
+		if (!Node::isFlagged(childEdge->load(std::memory_order_acquire)))
+			std::swap(childEdge, siblingEdge);
+
+		// freeze the sibling edge, then move the sibling up, keeping its flag if it is being removed as well
+		const uintptr_t siblingValue = siblingEdge->fetch_or(Node::TAG, std::memory_order_acq_rel);
+		uintptr_t expected = Node::toEdge(successorNode);
+		if (!successorEdge.compare_exchange_strong(expected, siblingValue & ~Node::TAG, std::memory_order_acq_rel))
+			return false;
+
+		// only the thread whose CAS unlinked the chain retires it: every internal node from successor to parent
+		// and the flagged leaf hanging off each of them. The chain is frozen, so walking it is safe.
+		Node *currNode = successorNode;
+		while (currNode != parentNode)
+		{
+			const bool isLeft = currNode->isLeftOf(data);
+			Node *pathNode = Node::getAddress((isLeft ? currNode->getLeftEdge() : currNode->getRightEdge()).load(std::memory_order_acquire));
+			guard.retire(Node::getAddress((isLeft ? currNode->getRightEdge() : currNode->getLeftEdge()).load(std::memory_order_acquire)));
+			guard.retire(currNode);
+			currNode = pathNode;
+		}
+		guard.retire(Node::getAddress(childEdge->load(std::memory_order_acquire)));
+		guard.retire(parentNode);
+		return true;
+	}
+
+private:
+	Node *rootNode;
+	EpochReclamation reclamation;
+};
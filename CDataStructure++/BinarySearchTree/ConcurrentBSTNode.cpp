@@ -0,0 +1 @@
+#include <ConcurrentBSTNode.h>
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Node of the ConcurrentBST. Leaves hold the data of the set, internal nodes only route: data smaller than the
+ * data of an internal node is in its left subtree, everything else in its right subtree.
+ *
+ * The child pointers are edges that carry two bits in the low bits of the address (nodes are at least 4 byte
+ * aligned): FLAG marks that the leaf at the end of the edge is being removed and TAG marks that the edge must not
+ * change anymore because its node is being unlinked.
+ */
+template <typename T>
+class ConcurrentBSTNode
+{
+public:
+	static constexpr uintptr_t FLAG = 1;
+	static constexpr uintptr_t TAG = 2;
+
+	// sentinels are larger than all data: 1 < 2 < 3, data nodes have infinity 0
+	explicit ConcurrentBSTNode(
+		const T &data,
+		const unsigned char infinity = 0,
+		ConcurrentBSTNode *left = nullptr,
+		ConcurrentBSTNode *right = nullptr)
+		: data(data),
+		  infinity(infinity),
+		  left(reinterpret_cast<uintptr_t>(left)),
+		  right(reinterpret_cast<uintptr_t>(right))
+	{
+	}
+
+	inline const T &getData() const
+	{
+		return data;
+	}
+
+	inline unsigned char getInfinity() const
+	{
+		return infinity;
+	}
+
+	inline std::atomic<uintptr_t> &getLeftEdge()
+	{
+		return left;
+	}
+
+	inline std::atomic<uintptr_t> &getRightEdge()
+	{
+		return right;
+	}
+
+	// data is routed to the left of this node
+	inline bool isLeftOf(const T &otherData) const
+	{
+		return infinity != 0 || otherData < data;
+	}
+
+	inline bool isLeaf() const
+	{
+		return left.load(std::memory_order_acquire) == 0;
+	}
+
+	inline bool holds(const T &otherData) const
+	{
+		return infinity == 0 && data == otherData;
+	}
+
+	static inline ConcurrentBSTNode *getAddress(const uintptr_t edge)
+	{
+		return reinterpret_cast<ConcurrentBSTNode *>(edge & ~(FLAG | TAG));
+	}
+
+	static inline bool isFlagged(const uintptr_t edge)
+	{
+		return (edge & FLAG) != 0;
+	}
+
+	static inline bool isTagged(const uintptr_t edge)
+	{
+		return (edge & TAG) != 0;
+	}
+
+	static inline uintptr_t toEdge(const ConcurrentBSTNode *node, const uintptr_t bits = 0)
+	{
+		return reinterpret_cast<uintptr_t>(node) | bits;
+	}
+
+private:
+	const T data;
+	const unsigned char infinity;
+	std::atomic<uintptr_t> left;
+	std::atomic<uintptr_t> right;
+};
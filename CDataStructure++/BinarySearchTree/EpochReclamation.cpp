@@ -0,0 +1 @@
+#include <EpochReclamation.h>
\ No newline at end of file
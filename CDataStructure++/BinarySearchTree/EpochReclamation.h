@@ -0,0 +1,191 @@
+#pragma once
+#include <Trace.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Epoch-based memory reclamation for lock-free data structures.
+ *
+ * A thread pins the current global epoch for the duration of an operation (Guard). Memory that was unlinked
+ * during the operation is retired into a bag of the current epoch instead of being freed. The global epoch only
+ * advances once every pinned thread has seen the current epoch, so two advances after a retirement no thread can
+ * still hold a reference to the retired memory and the bag is freed.
+ *
+ * Threads don't register: a Guard grabs any free per-thread record (creating one if all are taken) and gives it
+ * back at the end of the operation, so the amount of records is the maximum amount of concurrent operations.
+ */
+class EpochReclamation
+{
+private:
+	struct Retired
+	{
+		void *pointer;
+		void (*deleter)(void *);
+	};
+
+	struct Bag
+	{
+		uint64_t epoch = 0;
+		std::vector<Retired> items;
+	};
+
+	struct Record
+	{
+		std::atomic<bool> inUse{true};
+		std::atomic<uint64_t> pinnedEpoch{0}; // (epoch << 1) | 1 while pinned, 0 otherwise
+		Record *next = nullptr;
+		Bag bags[3]; // indexed by epoch % 3, only the holder of the record touches them
+		size_t retiredSinceAdvance = 0;
+	};
+
+public:
+	class Guard
+	{
+	public:
+		explicit Guard(EpochReclamation &reclamation)
+			: reclamation(reclamation),
+			  record(reclamation.pin())
+		{
+		}
+
+		Guard(const Guard &) = delete;
+		Guard &operator=(const Guard &) = delete;
+
+		~Guard()
+		{
+			reclamation.unpin(record);
+		}
+
+		/*
+		 *	Frees pointer with delete once no thread can reach it anymore. It has to be unlinked already.
+		 */
+		template <typename Type>
+		void retire(Type *pointer)
+		{
+			reclamation.retire(record, pointer, [](void *retired)
+							   { delete static_cast<Type *>(retired); });
+		}
+
+	private:
+		EpochReclamation &reclamation;
+		Record *record;
+	};
+
+public:
+	EpochReclamation() = default;
+
+	// Delete constructors which may cause headache and bugs
+	EpochReclamation(const EpochReclamation &) = delete;
+	EpochReclamation(EpochReclamation &&) = delete;
+
+	~EpochReclamation()
+	{
+		// no thread is pinned anymore, everything retired can go
+		Record *currRecord = records.load();
+		while (currRecord != nullptr)
+		{
+			Record *nextRecord = currRecord->next;
+			for (Bag &bag : currRecord->bags)
+			{
+				freeBag(bag);
+			}
+			delete currRecord;
+			currRecord = nextRecord;
+		}
+	}
+
+private:
+	// retirements per record between attempts to advance the global epoch
+	static constexpr size_t ADVANCE_INTERVAL = 64;
+
+	Record *pin()
+	{
+		Record *record = acquireRecord();
+		const uint64_t epoch = globalEpoch.load();
+		// seq_cst: the pinned epoch is visible to tryAdvance before this thread reads any node
+		record->pinnedEpoch.store((epoch << 1) | 1);
+
+		// bags two or more epochs behind can't be reached by anyone anymore
+		for (Bag &bag : record->bags)
+		{
+			if (!bag.items.empty() && bag.epoch + 2 <= epoch)
+				freeBag(bag);
+		}
+		return record;
+	}
+
+	void unpin(Record *record)
+	{
+		record->pinnedEpoch.store(0, std::memory_order_release);
+		record->inUse.store(false, std::memory_order_release);
+	}
+
+	void retire(Record *record, void *pointer, void (*deleter)(void *))
+	{
+		// the current epoch, not the pinned one: this thread may have pinned an epoch that others already advanced
+		// past, and threads that pinned since then can still be reading the retired memory
+		const uint64_t epoch = globalEpoch.load();
+		Bag &bag = record->bags[epoch % 3];
+		if (bag.epoch != epoch)
+		{
+			// the bag still holds items of epoch - 3 or older
+			freeBag(bag);
+			bag.epoch = epoch;
+		}
+		bag.items.push_back({pointer, deleter});
+
+		if (++record->retiredSinceAdvance >= ADVANCE_INTERVAL)
+		{
+			record->retiredSinceAdvance = 0;
+			tryAdvance(epoch);
+		}
+	}
+
+	void tryAdvance(const uint64_t epoch)
+	{
+		TRACE_SCOPE("EpochReclamation::tryAdvance");
+		for (Record *currRecord = records.load(); currRecord != nullptr; currRecord = currRecord->next)
+		{
+			const uint64_t pinnedEpoch = currRecord->pinnedEpoch.load();
+			if ((pinnedEpoch & 1) != 0 && (pinnedEpoch >> 1) != epoch)
+				return;
+		}
+		uint64_t expected = epoch;
+		globalEpoch.compare_exchange_strong(expected, epoch + 1);
+	}
+
+	Record *acquireRecord()
+	{
+		for (Record *currRecord = records.load(std::memory_order_acquire); currRecord != nullptr; currRecord = currRecord->next)
+		{
+			bool expected = false;
+			if (!currRecord->inUse.load(std::memory_order_relaxed) &&
+				currRecord->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				return currRecord;
+		}
+
+		// all records are held by other operations, records are only freed with the reclamation itself
+		Record *newRecord = new Record();
+		newRecord->next = records.load(std::memory_order_relaxed);
+		while (!records.compare_exchange_weak(newRecord->next, newRecord, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		return newRecord;
+	}
+
+	static void freeBag(Bag &bag)
+	{
+		TRACE_SCOPE("EpochReclamation::freeBag");
+		for (const Retired &retired : bag.items)
+		{
+			retired.deleter(retired.pointer);
+		}
+		bag.items.clear();
+	}
+
+private:
+	std::atomic<uint64_t> globalEpoch{0};
+	std::atomic<Record *> records{nullptr}; // push-only list
+};
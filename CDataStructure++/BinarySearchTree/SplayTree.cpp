@@ -0,0 +1 @@
+#include <SplayTree.h>
\ No newline at end of file
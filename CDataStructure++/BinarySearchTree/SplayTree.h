@@ -0,0 +1,250 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <Trace.h>
+#include "BinarySearchTreeNode.h"
+
+/*
+* Self-adjusting binary search tree on BinarySearchTreeNode. Every find, insertNode and removeNode splays the
+* accessed key to the root, so frequently accessed keys stay near the top and are found in a few steps.
+* Operations take O(log n) amortized. The splaying is done top-down in a single pass, so no parent pointers are needed.
+*/
+template<typename T>
+class SplayTree
+{
+public:
+	SplayTree()
+		:
+		root(nullptr)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	SplayTree(const SplayTree<T>&) = delete;
+	SplayTree(SplayTree<T>&&) = delete;
+
+	~SplayTree()
+	{
+		cleanUpTree();
+	}
+
+	void printTree()
+	{
+		std::cout << "Printing the Splay Tree\n";
+		std::cout << "|-- = left node (value < parent value)\n";
+		std::cout << "\\-- = right/root node (value > parent value)\n\n";
+		if (root != nullptr)
+			printTree("", root, false);
+	}
+
+	BinarySearchTreeNode<T>* getRoot()
+	{
+		return root;
+	}
+
+	/*
+	* Returns the node with given data, which is the root afterwards, or nullptr if it does not exist.
+	*/
+	BinarySearchTreeNode<T>* find(const T& data)
+	{
+		root = splay(data, root);
+		if (root != nullptr && root->getData() == data)
+		{
+			return root;
+		}
+		return nullptr;
+	}
+
+	/*
+	* Insert given data as new root. Returns false if the data was already present.
+	*/
+	bool insertNode(const T& data)
+	{
+		root = splay(data, root);
+		if (root != nullptr && root->getData() == data)
+		{
+			// don't add a node with the same data value twice
+			return false;
+		}
+
+		// after splaying, the root is the neighbour of data, so the tree splits below the new node
+		BinarySearchTreeNode<T>* newNode = new BinarySearchTreeNode<T>(data);
+		if (root != nullptr)
+		{
+			if (data < root->getData())
+			{
+				newNode->setLeft(root->getLeft());
+				newNode->setRight(root);
+				root->setLeft(nullptr);
+			}
+			else
+			{
+				newNode->setRight(root->getRight());
+				newNode->setLeft(root);
+				root->setRight(nullptr);
+			}
+		}
+		root = newNode;
+		return true;
+	}
+
+	/*
+	* Remove node with given data. Returns false if no node with the given data exists.
+	*/
+	bool removeNode(const T& data)
+	{
+		root = splay(data, root);
+		if (root == nullptr || !(root->getData() == data))
+		{
+			return false;
+		}
+
+		BinarySearchTreeNode<T>* oldRoot = root;
+		if (!oldRoot->hasLeft())
+		{
+			root = oldRoot->getRight();
+		}
+		else
+		{
+			// splaying data in the left subtree brings its largest node up, which has no right child
+			root = splay(data, oldRoot->getLeft());
+			root->setRight(oldRoot->getRight());
+		}
+		delete oldRoot;
+		return true;
+	}
+
+private:
+	/*
+	* Top-down splay: walks down from currRoot towards data and hangs the nodes passed on the way into a left
+	* tree (smaller than data) and a right tree (larger than data). Two steps in the same direction rotate first
+	* (zig-zig), which is what halves the depth of the access path. Finally the last node visited becomes the root
+	* with the left and right tree as its subtrees.
+	*/
+	BinarySearchTreeNode<T>* splay(const T& data, BinarySearchTreeNode<T>* currRoot)
+	{
+		TRACE_SCOPE("SplayTree::splay");
+		if (currRoot == nullptr)
+		{
+			return nullptr;
+		}
+
+		BinarySearchTreeNode<T>* leftTreeRoot = nullptr;
+		BinarySearchTreeNode<T>* leftTreeMax = nullptr;
+		BinarySearchTreeNode<T>* rightTreeRoot = nullptr;
+		BinarySearchTreeNode<T>* rightTreeMin = nullptr;
+
+		while (true)
+		{
+			if (data < currRoot->getData())
+			{
+				if (!currRoot->hasLeft())
+					break;
+
+				if (data < currRoot->getLeft()->getData())
+				{
+					// zig-zig: rotate right
+					BinarySearchTreeNode<T>* leftNode = currRoot->getLeft();
+					currRoot->setLeft(leftNode->getRight());
+					leftNode->setRight(currRoot);
+					currRoot = leftNode;
+					if (!currRoot->hasLeft())
+						break;
+				}
+
+				// link currRoot as smallest node of the right tree
+				if (rightTreeMin != nullptr)
+					rightTreeMin->setLeft(currRoot);
+				else
+					rightTreeRoot = currRoot;
+				rightTreeMin = currRoot;
+				currRoot = currRoot->getLeft();
+			}
+			else if (data > currRoot->getData())
+			{
+				if (!currRoot->hasRight())
+					break;
+
+				if (data > currRoot->getRight()->getData())
+				{
+					// zag-zag: rotate left
+					BinarySearchTreeNode<T>* rightNode = currRoot->getRight();
+					currRoot->setRight(rightNode->getLeft());
+					rightNode->setLeft(currRoot);
+					currRoot = rightNode;
+					if (!currRoot->hasRight())
+						break;
+				}
+
+				// link currRoot as largest node of the left tree
+				if (leftTreeMax != nullptr)
+					leftTreeMax->setRight(currRoot);
+				else
+					leftTreeRoot = currRoot;
+				leftTreeMax = currRoot;
+				currRoot = currRoot->getRight();
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		// assemble: the subtrees of the new root go to the inner sides of the left and right tree
+		if (leftTreeMax != nullptr)
+		{
+			leftTreeMax->setRight(currRoot->getLeft());
+			currRoot->setLeft(leftTreeRoot);
+		}
+		if (rightTreeMin != nullptr)
+		{
+			rightTreeMin->setLeft(currRoot->getRight());
+			currRoot->setRight(rightTreeRoot);
+		}
+		return currRoot;
+	}
+
+	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
+	void printTree(const std::string& prefix, BinarySearchTreeNode<T>* node, bool isLeft)
+	{
+		if (node != nullptr)
+		{
+			std::cout << prefix;
+
+			std::cout << (isLeft ? "|-- " : "\\-- ");
+
+			// print the value of the node
+			std::cout << "(" << node->getData() << ")" << std::endl;
+
+			// enter the next tree level - left and right branch
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		}
+	}
+
+	void cleanUpTree()
+	{
+		// A splay tree can be as deep as it has nodes (e.g. after sorted inserts), so instead of recursing the
+		// left children are rotated up until the root has none and can be deleted.
+		while (root != nullptr)
+		{
+			if (root->hasLeft())
+			{
+				BinarySearchTreeNode<T>* leftNode = root->getLeft();
+				root->setLeft(leftNode->getRight());
+				leftNode->setRight(root);
+				root = leftNode;
+			}
+			else
+			{
+				BinarySearchTreeNode<T>* rightNode = root->getRight();
+				delete root;
+				root = rightNode;
+			}
+		}
+	}
+
+private:
+	BinarySearchTreeNode<T>* root;
+};
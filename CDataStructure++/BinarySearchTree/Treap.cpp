@@ -0,0 +1 @@
+#include <Treap.h>
\ No newline at end of file
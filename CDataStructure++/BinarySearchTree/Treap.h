@@ -0,0 +1,271 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <Trace.h>
+#include "TreapNode.h"
+
+/*
+* Randomized binary search tree: ordered by data like BinarySearchTree and heap-ordered by a random priority per
+* node. The shape is that of a BinarySearchTree built from a random insertion order, so the height is O(log n) in
+* expectation for any input order, including sorted input.
+* Because the shape only depends on the data and the priorities, split and merge can cut and glue whole trees in
+* O(log n) by walking a single path, which makes partitioning a tree into ranges and rejoining them cheap.
+*/
+template<typename T>
+class Treap
+{
+public:
+	explicit Treap(const uint32_t seed = std::random_device()())
+		:
+		root(nullptr),
+		generator(seed)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	Treap(const Treap<T>&) = delete;
+	Treap(Treap<T>&&) = delete;
+
+	~Treap()
+	{
+		cleanUpTree();
+	}
+
+	void printTree()
+	{
+		std::cout << "Printing the Treap\n";
+		std::cout << "|-- = left node (value < parent value)\n";
+		std::cout << "\\-- = right/root node (value > parent value)\n\n";
+		if (root != nullptr)
+			printTree("", root, false);
+	}
+
+	TreapNode<T>* getRoot()
+	{
+		return root;
+	}
+
+	/*
+	* Returns the node with given data or nullptr if it does not exist.
+	*/
+	TreapNode<T>* find(const T& data)
+	{
+		TreapNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (data < currNode->getData())
+			{
+				currNode = currNode->getLeft();
+			}
+			else if (data > currNode->getData())
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				return currNode;
+			}
+		}
+		return nullptr;
+	}
+
+	/*
+	* Returns false if the data was already present.
+	*/
+	bool insertNode(const T& data)
+	{
+		if (find(data) != nullptr)
+		{
+			// don't add a node with the same data value twice
+			return false;
+		}
+
+		TreapNode<T>* newNode = new TreapNode<T>(data, generator());
+
+		// walk down until the new node outranks the subtree, then split that subtree around the new node
+		TreapNode<T>** link = &root;
+		while (*link != nullptr && (*link)->getPriority() >= newNode->getPriority())
+		{
+			link = data < (*link)->getData() ? &(*link)->getLeftLink() : &(*link)->getRightLink();
+		}
+		TreapNode<T>* smaller = nullptr;
+		TreapNode<T>* greater = nullptr;
+		splitNode(*link, data, smaller, greater);
+		newNode->setLeft(smaller);
+		newNode->setRight(greater);
+		*link = newNode;
+		return true;
+	}
+
+	/*
+	* Remove node with given data. Returns false if no node with the given data exists.
+	*/
+	bool removeNode(const T& data)
+	{
+		TreapNode<T>** link = &root;
+		while (*link != nullptr && !((*link)->getData() == data))
+		{
+			link = data < (*link)->getData() ? &(*link)->getLeftLink() : &(*link)->getRightLink();
+		}
+		if (*link == nullptr)
+		{
+			return false;
+		}
+
+		TreapNode<T>* oldNode = *link;
+		*link = mergeNodes(oldNode->getLeft(), oldNode->getRight());
+		delete oldNode;
+		return true;
+	}
+
+	/*
+	* Moves every node with data >= key into greater, which has to be empty. Expected O(log n).
+	*/
+	void split(const T& key, Treap<T>& greater)
+	{
+		TRACE_SCOPE("Treap::split");
+		if (&greater == this || greater.root != nullptr)
+		{
+			throw std::invalid_argument("Treap::split needs a different, empty treap");
+		}
+		TreapNode<T>* smaller = nullptr;
+		splitNode(root, key, smaller, greater.root);
+		root = smaller;
+	}
+
+	/*
+	* Moves every node of greater into this treap, greater is empty afterwards. All data in greater has to be larger
+	* than the data in this treap. Expected O(log n).
+	*/
+	void merge(Treap<T>& greater)
+	{
+		TRACE_SCOPE("Treap::merge");
+		if (&greater == this)
+		{
+			return;
+		}
+		if (root != nullptr && greater.root != nullptr && !(maxNode(root)->getData() < minNode(greater.root)->getData()))
+		{
+			throw std::invalid_argument("Treap::merge needs all data of greater to be larger");
+		}
+		root = mergeNodes(root, greater.root);
+		greater.root = nullptr;
+	}
+
+private:
+	/*
+	* Splits the subtree of currNode into the nodes smaller than key and the nodes not smaller than key. Only the
+	* path to key is touched: every node on it keeps the side of its subtree that is on its own side of the key and
+	* gets the split of the other side attached.
+	*/
+	static void splitNode(TreapNode<T>* currNode, const T& key, TreapNode<T>*& smaller, TreapNode<T>*& greater)
+	{
+		TreapNode<T>** smallerLink = &smaller;
+		TreapNode<T>** greaterLink = &greater;
+		while (currNode != nullptr)
+		{
+			if (currNode->getData() < key)
+			{
+				*smallerLink = currNode;
+				smallerLink = &currNode->getRightLink();
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				*greaterLink = currNode;
+				greaterLink = &currNode->getLeftLink();
+				currNode = currNode->getLeft();
+			}
+		}
+		*smallerLink = nullptr;
+		*greaterLink = nullptr;
+	}
+
+	/*
+	* Joins two subtrees where all data of smaller is less than all data of greater. Walks down the right spine of
+	* smaller and the left spine of greater and interleaves them by priority.
+	*/
+	static TreapNode<T>* mergeNodes(TreapNode<T>* smaller, TreapNode<T>* greater)
+	{
+		TreapNode<T>* merged = nullptr;
+		TreapNode<T>** link = &merged;
+		while (smaller != nullptr && greater != nullptr)
+		{
+			if (smaller->getPriority() >= greater->getPriority())
+			{
+				*link = smaller;
+				link = &smaller->getRightLink();
+				smaller = smaller->getRight();
+			}
+			else
+			{
+				*link = greater;
+				link = &greater->getLeftLink();
+				greater = greater->getLeft();
+			}
+		}
+		*link = smaller != nullptr ? smaller : greater;
+		return merged;
+	}
+
+	static TreapNode<T>* minNode(TreapNode<T>* currNode)
+	{
+		while (currNode->hasLeft())
+			currNode = currNode->getLeft();
+		return currNode;
+	}
+
+	static TreapNode<T>* maxNode(TreapNode<T>* currNode)
+	{
+		while (currNode->hasRight())
+			currNode = currNode->getRight();
+		return currNode;
+	}
+
+	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
+	void printTree(const std::string& prefix, TreapNode<T>* node, bool isLeft)
+	{
+		if (node != nullptr)
+		{
+			std::cout << prefix;
+
+			std::cout << (isLeft ? "|-- " : "\\-- ");
+
+			// print the value of the node
+			std::cout << "(" << node->getData() << ")" << std::endl;
+
+			// enter the next tree level - left and right branch
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		}
+	}
+
+	void cleanUpTree()
+	{
+		// rotate left children up until the root has none, then it can be deleted without recursing
+		while (root != nullptr)
+		{
+			if (root->hasLeft())
+			{
+				TreapNode<T>* leftNode = root->getLeft();
+				root->setLeft(leftNode->getRight());
+				leftNode->setRight(root);
+				root = leftNode;
+			}
+			else
+			{
+				TreapNode<T>* rightNode = root->getRight();
+				delete root;
+				root = rightNode;
+			}
+		}
+	}
+
+private:
+	TreapNode<T>* root;
+	std::mt19937 generator; // draws the node priorities
+};
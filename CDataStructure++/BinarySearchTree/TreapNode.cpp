@@ -0,0 +1 @@
+#include <TreapNode.h>
\ No newline at end of file
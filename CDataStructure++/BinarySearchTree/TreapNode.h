@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+template<typename T>
+class TreapNode
+{
+public:
+	explicit TreapNode(
+		const T& data,
+		const uint32_t priority,
+		TreapNode* left = nullptr,
+		TreapNode* right = nullptr
+	)
+		:
+		data(data),
+		priority(priority),
+		left(left),
+		right(right)
+	{
+	}
+
+	TreapNode* getLeft()
+	{
+		return left;
+	}
+
+	TreapNode* getRight()
+	{
+		return right;
+	}
+
+	bool hasRight()
+	{
+		return right != nullptr;
+	}
+
+	bool hasLeft()
+	{
+		return left != nullptr;
+	}
+
+	const T& getData()
+	{
+		return data;
+	}
+
+	uint32_t getPriority()
+	{
+		return priority;
+	}
+
+	// the child pointers themselves, so that Treap can rewire a path while walking it
+	TreapNode*& getLeftLink()
+	{
+		return left;
+	}
+
+	TreapNode*& getRightLink()
+	{
+		return right;
+	}
+
+	void setLeft(TreapNode* newLeft)
+	{
+		this->left = newLeft;
+	}
+
+	void setRight(TreapNode* newRight)
+	{
+		this->right = newRight;
+	}
+
+private:
+	const T data;
+	const uint32_t priority; // random, a node's priority is never smaller than the priorities of its children
+	TreapNode* left;
+	TreapNode* right;
+};
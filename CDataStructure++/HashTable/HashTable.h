@@ -6,6 +6,8 @@
 #include <memory>
 #include <functional>
 #include "../LinkedList/LinkedList.h"
+#include <MemoryUsage.h>
+#include <Trace.h>
 
 template<typename K, typename V>
 class HashTable
@@ -29,6 +31,7 @@ public:
 
 	void put(const K& key, const V& value)
 	{
+		TRACE_SCOPE("HashTable::put");
 		const auto idx = hashFunc(key);
 
 		//std::cout << "Hash Function Index: " << idx << std::endl;
@@ -52,6 +55,7 @@ public:
 
 	void deleteKey(const K& key)
 	{
+		TRACE_SCOPE("HashTable::deleteKey");
 		const auto idx = hashFunc(key);
 		delete hashTable[idx];
 		hashTable[idx] = nullptr;
@@ -62,6 +66,26 @@ public:
 		return std::hash<K>{}(key) % capacity;
 	}
 
+	/*
+	*	Heap memory of the bin array, the lists of the used bins and their nodes. Visits every bin, O(capacity).
+	*/
+	MemoryUsage memoryUsage() const
+	{
+		MemoryUsage usage;
+		usage.allocations = 1;
+		usage.bytesLive = capacity * sizeof(LinkedList<V>*);
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (hashTable[i] != nullptr)
+			{
+				++usage.allocations;
+				usage.bytesLive += sizeof(LinkedList<V>);
+				usage += hashTable[i]->memoryUsage();
+			}
+		}
+		return usage;
+	}
+
 	void printBinsInfo() const
 	{
 		for (size_t i = 0; i < capacity; ++i)
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <future>
 #include <iostream>
 #include <memory>
 #include "Node.h"
+#include <MemoryUsage.h>
+#include <TeardownQueue.h>
+#include <Trace.h>
 
 template<typename V>
 class LinkedList
@@ -24,13 +28,31 @@ public:
 
 	~LinkedList()
 	{
-		Node<V>* tempNext = headNode;
-		while (tempNext != nullptr)
-		{
-			auto temp = tempNext->next;
-			delete tempNext;
-			tempNext = temp;
-		}
+		deleteNodes(headNode);
+	}
+
+	/*
+	*	Deletes all nodes.
+	*/
+	void clear()
+	{
+		deleteNodes(headNode);
+		headNode = nullptr;
+		size = 0;
+	}
+
+	/*
+	*	Detaches all nodes in O(1) and deletes them on the TeardownQueue thread, the list is empty and usable right
+	*	away. The returned future is ready once every node is freed, it can be dropped without waiting: the
+	*	TeardownQueue finishes before the program exits.
+	*/
+	std::future<void> clearDeferred()
+	{
+		Node<V>* oldHead = headNode;
+		headNode = nullptr;
+		size = 0;
+
+		return TeardownQueue::enqueue([oldHead]() { deleteNodes(oldHead); });
 	}
 
 	void printNodes(const size_t depth = 5)
@@ -122,6 +144,7 @@ public:
 					// delete node somewhere in the linked list
 					prevNode->next = currNode->next;
 					delete currNode;
+					--size;
 					currNode = prevNode->next;
 				}
 				amountNodesDeleted++;
@@ -150,6 +173,7 @@ public:
 		auto tempNext = this->headNode->next;
 		delete this->headNode;
 		this->headNode = tempNext;
+		--size;
 	}
 
 	/*
@@ -175,6 +199,31 @@ public:
 		return this->size;
 	}
 
+	/*
+	*	Heap memory of the nodes, one allocation per element. Memory that V itself allocates (e.g. a long
+	*	std::string) isn't included, AllocationTracker measures it.
+	*/
+	MemoryUsage memoryUsage() const
+	{
+		MemoryUsage usage;
+		usage.allocations = size;
+		usage.bytesLive = size * sizeof(Node<V>);
+		usage.elements = size;
+		return usage;
+	}
+
+private:
+	static void deleteNodes(Node<V>* currNode)
+	{
+		TRACE_SCOPE("LinkedList::deleteNodes");
+		while (currNode != nullptr)
+		{
+			auto temp = currNode->next;
+			delete currNode;
+			currNode = temp;
+		}
+	}
+
 private:
 	Node<V>* headNode;
 	size_t size;
@@ -0,0 +1 @@
+#include <RedBlackTree.h>
\ No newline at end of file
@@ -0,0 +1,451 @@
+#pragma once
+#include <RedBlackTreeNode.h>
+#include <Trace.h>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+/*
+ * Red-black tree with the interface of AVLTree (insertNode, removeNode, searchNode) plus in-order iteration.
+ *
+ * The balancing is looser than AVL: the longest path is at most twice the shortest, so searches can be a bit
+ * deeper. In exchange an insertion needs at most 2 rotations and a removal at most 3, the remaining fix-up work
+ * is recoloring, which makes it the better choice for write-heavy workloads (see app bench-red-black).
+ */
+template <typename T>
+class RedBlackTree
+{
+public:
+	using Node = RedBlackTreeNode<T>;
+
+	// forward iterator over the data in ascending order, follows the parent links so it needs no stack
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T *;
+		using reference = const T &;
+
+		explicit Iterator(Node *node)
+			: currNode(node)
+		{
+		}
+
+		reference operator*() const
+		{
+			return currNode->getData();
+		}
+
+		pointer operator->() const
+		{
+			return &currNode->getData();
+		}
+
+		Iterator &operator++()
+		{
+			currNode = findInorderSuccessor(currNode);
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const Iterator &other) const
+		{
+			return currNode == other.currNode;
+		}
+
+		bool operator!=(const Iterator &other) const
+		{
+			return currNode != other.currNode;
+		}
+
+	private:
+		Node *currNode;
+	};
+
+public:
+	RedBlackTree()
+		: root(nullptr)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	RedBlackTree(const RedBlackTree &) = delete;
+	RedBlackTree(RedBlackTree &&) = delete;
+
+	~RedBlackTree()
+	{
+		cleanUpTree(root);
+	}
+
+	void printTree()
+	{
+		std::cout << "Printing the Red-Black Tree\n";
+		std::cout << "|-- = left node (value < parent value)\n";
+		std::cout << "\\-- = right/root node (value > parent value)\n\n";
+		if (root != nullptr)
+			printTree("", root, false);
+	}
+
+	void insertNode(const T &data)
+	{
+		emplaceNode(data, data);
+	}
+
+	void insertNode(T &&data)
+	{
+		// data is only moved into the node after all comparisons are done
+		emplaceNode(data, std::move(data));
+	}
+
+	/*
+	 *	Remove node with given data. Rebalance tree appropriately.
+	 *	Returns false if no node with the given data exists.
+	 */
+	bool removeNode(const T &data)
+	{
+		Node *nodeToRemove = searchNode(data);
+		if (nodeToRemove == nullptr)
+			return false;
+
+		// the node that actually leaves its position: nodeToRemove itself or, with two children, its successor
+		bool removedBlack = !nodeToRemove->isRed();
+		Node *replacingNode = nullptr;
+		Node *parentReplacingNode = nullptr;
+		if (!nodeToRemove->hasLeft() || !nodeToRemove->hasRight())
+		{
+			replacingNode = nodeToRemove->hasLeft() ? nodeToRemove->getLeft() : nodeToRemove->getRight();
+			parentReplacingNode = nodeToRemove->getParent();
+			replaceNode(nodeToRemove, replacingNode);
+		}
+		else
+		{
+			Node *inorderSuccessorNode = findMinNode(nodeToRemove->getRight());
+			removedBlack = !inorderSuccessorNode->isRed();
+			replacingNode = inorderSuccessorNode->getRight();
+			if (inorderSuccessorNode->getParent() == nodeToRemove)
+			{
+				parentReplacingNode = inorderSuccessorNode;
+			}
+			else
+			{
+				parentReplacingNode = inorderSuccessorNode->getParent();
+				replaceNode(inorderSuccessorNode, replacingNode);
+				inorderSuccessorNode->setRight(nodeToRemove->getRight());
+				inorderSuccessorNode->getRight()->setParent(inorderSuccessorNode);
+			}
+			// the successor takes over position and color of the removed node
+			replaceNode(nodeToRemove, inorderSuccessorNode);
+			inorderSuccessorNode->setLeft(nodeToRemove->getLeft());
+			inorderSuccessorNode->getLeft()->setParent(inorderSuccessorNode);
+			inorderSuccessorNode->setRed(nodeToRemove->isRed());
+		}
+		delete nodeToRemove;
+		--nodeCount;
+
+		// removing a black node leaves its paths one black node short
+		if (removedBlack)
+			rebalanceTreeDeletion(replacingNode, parentReplacingNode);
+		return true;
+	}
+
+	Node *getRoot()
+	{
+		return this->root;
+	}
+
+	Node *searchNode(const T &data)
+	{
+		Node *currNode = root;
+		while (currNode != nullptr)
+		{
+			if (currNode->getData() == data)
+				return currNode;
+			// choosing the child by a select instead of a second comparison branch avoids a misprediction per level
+			currNode = data < currNode->getData() ? currNode->getLeft() : currNode->getRight();
+		}
+		return nullptr;
+	}
+
+	size_t getSize() const
+	{
+		return nodeCount;
+	}
+
+	Iterator begin()
+	{
+		return Iterator(root == nullptr ? nullptr : findMinNode(root));
+	}
+
+	Iterator end()
+	{
+		return Iterator(nullptr);
+	}
+
+private:
+	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
+	void printTree(const std::string &prefix, Node *node, bool isLeft)
+	{
+		if (node != nullptr)
+		{
+			std::cout << prefix;
+
+			std::cout << (isLeft ? "|-- " : "\\-- ");
+
+			// print the value of the node
+			std::cout << "(" << node->getData() << ", " << (node->isRed() ? "red" : "black") << ")" << std::endl;
+
+			// enter the next tree level - left and right branch
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		}
+	}
+
+	template <typename... Args>
+	void emplaceNode(const T &data, Args &&...args)
+	{
+		Node *parentNode = nullptr;
+		Node *currNode = root;
+		while (currNode != nullptr)
+		{
+			parentNode = currNode;
+			if (data < currNode->getData())
+				currNode = currNode->getLeft();
+			else if (data > currNode->getData())
+				currNode = currNode->getRight();
+			else
+				return; // don't add a node with the same data value twice
+		}
+
+		Node *newNode = new Node(parentNode, std::forward<Args>(args)...);
+		if (parentNode == nullptr)
+			root = newNode;
+		else if (data < parentNode->getData())
+			parentNode->setLeft(newNode);
+		else
+			parentNode->setRight(newNode);
+		++nodeCount;
+
+		rebalanceTreeInsertion(newNode);
+	}
+
+	/*
+	 *	The new red node may have a red parent. While the uncle is red too, recoloring moves the conflict two
+	 *	levels up. Otherwise one or two rotations resolve it and the walk stops, so at most 2 rotations happen.
+	 */
+	void rebalanceTreeInsertion(Node *currNode)
+	{
+		while (currNode->hasParent() && currNode->getParent()->isRed())
+		{
+			Node *parentNode = currNode->getParent();
+			// a red parent is never the root, so the grandparent exists
+			Node *grandParentNode = parentNode->getParent();
+			const bool parentIsLeft = grandParentNode->getLeft() == parentNode;
+			Node *uncleNode = parentIsLeft ? grandParentNode->getRight() : grandParentNode->getLeft();
+
+			if (isRedNode(uncleNode))
+			{
+				parentNode->setRed(false);
+				uncleNode->setRed(false);
+				grandParentNode->setRed(true);
+				currNode = grandParentNode;
+				continue;
+			}
+
+			if (parentIsLeft)
+			{
+				// inner grandchild: rotate it to the outside first
+				if (parentNode->getRight() == currNode)
+				{
+					rotateLeft(parentNode);
+					parentNode = currNode;
+				}
+				rotateRight(grandParentNode);
+			}
+			else
+			{
+				if (parentNode->getLeft() == currNode)
+				{
+					rotateRight(parentNode);
+					parentNode = currNode;
+				}
+				rotateLeft(grandParentNode);
+			}
+			parentNode->setRed(false);
+			grandParentNode->setRed(true);
+			break;
+		}
+		root->setRed(false);
+	}
+
+	/*
+	 *	currNode (possibly nullptr, hence the explicit parent) is missing one black node on its paths. A red sibling
+	 *	is rotated up first, then either the sibling is recolored red and the shortage moves one level up, or at
+	 *	most two more rotations fix it for good. That bounds a removal to 3 rotations.
+	 */
+	void rebalanceTreeDeletion(Node *currNode, Node *parentNode)
+	{
+		while (currNode != root && !isRedNode(currNode))
+		{
+			if (parentNode->getLeft() == currNode)
+			{
+				// the sibling exists since its side has at least one more black node
+				Node *siblingNode = parentNode->getRight();
+				if (siblingNode->isRed())
+				{
+					siblingNode->setRed(false);
+					parentNode->setRed(true);
+					rotateLeft(parentNode);
+					siblingNode = parentNode->getRight();
+				}
+
+				if (!isRedNode(siblingNode->getLeft()) && !isRedNode(siblingNode->getRight()))
+				{
+					siblingNode->setRed(true);
+					currNode = parentNode;
+					parentNode = currNode->getParent();
+					continue;
+				}
+
+				if (!isRedNode(siblingNode->getRight()))
+				{
+					siblingNode->getLeft()->setRed(false);
+					siblingNode->setRed(true);
+					rotateRight(siblingNode);
+					siblingNode = parentNode->getRight();
+				}
+				siblingNode->setRed(parentNode->isRed());
+				parentNode->setRed(false);
+				siblingNode->getRight()->setRed(false);
+				rotateLeft(parentNode);
+			}
+			else
+			{
+				Node *siblingNode = parentNode->getLeft();
+				if (siblingNode->isRed())
+				{
+					siblingNode->setRed(false);
+					parentNode->setRed(true);
+					rotateRight(parentNode);
+					siblingNode = parentNode->getLeft();
+				}
+
+				if (!isRedNode(siblingNode->getLeft()) && !isRedNode(siblingNode->getRight()))
+				{
+					siblingNode->setRed(true);
+					currNode = parentNode;
+					parentNode = currNode->getParent();
+					continue;
+				}
+
+				if (!isRedNode(siblingNode->getLeft()))
+				{
+					siblingNode->getRight()->setRed(false);
+					siblingNode->setRed(true);
+					rotateLeft(siblingNode);
+					siblingNode = parentNode->getLeft();
+				}
+				siblingNode->setRed(parentNode->isRed());
+				parentNode->setRed(false);
+				siblingNode->getLeft()->setRed(false);
+				rotateRight(parentNode);
+			}
+			currNode = root;
+			break;
+		}
+		if (currNode != nullptr)
+			currNode->setRed(false);
+	}
+
+	// the right child of currNode takes its place, currNode becomes its left child
+	void rotateLeft(Node *currNode)
+	{
+		TRACE_SCOPE("RedBlackTree::rotateLeft");
+		Node *rightNode = currNode->getRight();
+		currNode->setRight(rightNode->getLeft());
+		if (rightNode->hasLeft())
+			rightNode->getLeft()->setParent(currNode);
+		replaceNode(currNode, rightNode);
+		rightNode->setLeft(currNode);
+		currNode->setParent(rightNode);
+	}
+
+	// the left child of currNode takes its place, currNode becomes its right child
+	void rotateRight(Node *currNode)
+	{
+		TRACE_SCOPE("RedBlackTree::rotateRight");
+		Node *leftNode = currNode->getLeft();
+		currNode->setLeft(leftNode->getRight());
+		if (leftNode->hasRight())
+			leftNode->getRight()->setParent(currNode);
+		replaceNode(currNode, leftNode);
+		leftNode->setRight(currNode);
+		currNode->setParent(leftNode);
+	}
+
+	// links newNode (may be nullptr) to the parent of oldNode in place of oldNode
+	inline void replaceNode(Node *oldNode, Node *newNode)
+	{
+		Node *parentNode = oldNode->getParent();
+		if (parentNode == nullptr)
+			root = newNode;
+		else if (parentNode->getLeft() == oldNode)
+			parentNode->setLeft(newNode);
+		else
+			parentNode->setRight(newNode);
+		if (newNode != nullptr)
+			newNode->setParent(parentNode);
+	}
+
+	// missing nodes (the leaves) count as black
+	static inline bool isRedNode(Node *currNode)
+	{
+		return currNode != nullptr && currNode->isRed();
+	}
+
+	static inline Node *findMinNode(Node *currNode)
+	{
+		while (currNode->hasLeft())
+			currNode = currNode->getLeft();
+		return currNode;
+	}
+
+	static Node *findInorderSuccessor(Node *currNode)
+	{
+		if (currNode->hasRight())
+			return findMinNode(currNode->getRight());
+
+		// climb until coming up from a left subtree, that parent is the next larger node
+		Node *parentNode = currNode->getParent();
+		while (parentNode != nullptr && parentNode->getRight() == currNode)
+		{
+			currNode = parentNode;
+			parentNode = parentNode->getParent();
+		}
+		return parentNode;
+	}
+
+	void cleanUpTree(Node *currNode)
+	{
+		// Post-order traversal, the height is at most 2 log(n) so the recursion stays shallow
+		if (currNode != nullptr)
+		{
+			cleanUpTree(currNode->getLeft());
+			cleanUpTree(currNode->getRight());
+			delete currNode;
+		}
+	}
+
+private:
+	Node *root;
+	size_t nodeCount = 0;
+};
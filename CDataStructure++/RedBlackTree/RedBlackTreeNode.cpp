@@ -0,0 +1 @@
+#include <RedBlackTreeNode.h>
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <utility>
+
+template <typename T>
+class RedBlackTreeNode
+{
+public:
+	// constructs the data in place from args, every inserted node starts off red so no black height changes
+	template <typename... Args>
+	explicit RedBlackTreeNode(
+		RedBlackTreeNode *parent,
+		Args &&...args)
+		: data(std::forward<Args>(args)...),
+		  left(nullptr),
+		  right(nullptr),
+		  parent(parent),
+		  red(true)
+	{
+	}
+
+	inline bool isRed() const
+	{
+		return red;
+	}
+
+	inline void setRed(const bool newRed)
+	{
+		this->red = newRed;
+	}
+
+	inline void setLeft(RedBlackTreeNode *newLeft)
+	{
+		this->left = newLeft;
+	}
+
+	inline void setRight(RedBlackTreeNode *newRight)
+	{
+		this->right = newRight;
+	}
+
+	inline void setParent(RedBlackTreeNode *newParent)
+	{
+		this->parent = newParent;
+	}
+
+	inline const T &getData() const
+	{
+		return data;
+	}
+
+	inline bool hasLeft() const
+	{
+		return left != nullptr;
+	}
+
+	inline bool hasRight() const
+	{
+		return right != nullptr;
+	}
+
+	inline bool hasParent() const
+	{
+		return parent != nullptr;
+	}
+
+	inline RedBlackTreeNode *getLeft()
+	{
+		return left;
+	}
+
+	inline RedBlackTreeNode *getRight()
+	{
+		return right;
+	}
+
+	inline RedBlackTreeNode *getParent()
+	{
+		return parent;
+	}
+
+private:
+	T data;
+	RedBlackTreeNode *left;
+	RedBlackTreeNode *right;
+	RedBlackTreeNode *parent;
+	bool red; // a red node never has a red child, and every path down to a leaf passes the same amount of black nodes
+};
@@ -0,0 +1,194 @@
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace
+{
+	std::atomic<size_t> totalAllocations{0};
+	std::atomic<size_t> liveAllocations{0};
+	std::atomic<size_t> liveBytes{0};
+	std::atomic<size_t> peakBytes{0};
+}
+
+MemoryUsage AllocationTracker::getUsage()
+{
+	MemoryUsage usage;
+	usage.allocations = liveAllocations.load(std::memory_order_relaxed);
+	usage.bytesLive = liveBytes.load(std::memory_order_relaxed);
+	usage.peakBytes = peakBytes.load(std::memory_order_relaxed);
+	return usage;
+}
+
+size_t AllocationTracker::getTotalAllocations()
+{
+	return totalAllocations.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::resetPeak()
+{
+	peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+#if defined(ALLOCATION_TRACKING)
+
+namespace
+{
+	// the requested size is stored in front of every block, so unsized deletes know what they free
+	constexpr size_t HEADER_SIZE = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+	void countAllocation(const size_t size)
+	{
+		totalAllocations.fetch_add(1, std::memory_order_relaxed);
+		liveAllocations.fetch_add(1, std::memory_order_relaxed);
+		const size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		size_t peak = peakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void countDeallocation(const size_t size)
+	{
+		liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+		liveBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	// header of HEADER_SIZE or alignment bytes (whichever is larger), the size is in its last bytes
+	void* allocate(const size_t size, const size_t alignment)
+	{
+		const size_t header = alignment > HEADER_SIZE ? alignment : HEADER_SIZE;
+#if defined(_MSC_VER)
+		void* block = _aligned_malloc(header + size, header);
+#else
+		void* block = nullptr;
+		if (header == HEADER_SIZE)
+			block = std::malloc(header + size);
+		else if (posix_memalign(&block, header, header + size) != 0)
+			block = nullptr;
+#endif
+		if (block == nullptr)
+			return nullptr;
+
+		char* memory = static_cast<char*>(block) + header;
+		reinterpret_cast<size_t*>(memory)[-1] = size;
+		countAllocation(size);
+		return memory;
+	}
+
+	void deallocate(void* memory, const size_t alignment)
+	{
+		if (memory == nullptr)
+			return;
+
+		const size_t header = alignment > HEADER_SIZE ? alignment : HEADER_SIZE;
+		countDeallocation(reinterpret_cast<size_t*>(memory)[-1]);
+#if defined(_MSC_VER)
+		_aligned_free(static_cast<char*>(memory) - header);
+#else
+		std::free(static_cast<char*>(memory) - header);
+#endif
+	}
+
+	void* allocateOrThrow(const size_t size, const size_t alignment)
+	{
+		while (true)
+		{
+			void* memory = allocate(size, alignment);
+			if (memory != nullptr)
+				return memory;
+
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr)
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+}
+
+void* operator new(const size_t size)
+{
+	return allocateOrThrow(size, HEADER_SIZE);
+}
+
+void* operator new[](const size_t size)
+{
+	return allocateOrThrow(size, HEADER_SIZE);
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size, HEADER_SIZE);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size, HEADER_SIZE);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+	return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+	return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+	deallocate(memory, HEADER_SIZE);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	deallocate(memory, HEADER_SIZE);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	deallocate(memory, HEADER_SIZE);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	deallocate(memory, HEADER_SIZE);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	deallocate(memory, HEADER_SIZE);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	deallocate(memory, HEADER_SIZE);
+}
+
+void operator delete(void* memory, const std::align_val_t alignment) noexcept
+{
+	deallocate(memory, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* memory, const std::align_val_t alignment) noexcept
+{
+	deallocate(memory, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory, size_t, const std::align_val_t alignment) noexcept
+{
+	deallocate(memory, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* memory, size_t, const std::align_val_t alignment) noexcept
+{
+	deallocate(memory, static_cast<size_t>(alignment));
+}
+
+#endif
\ No newline at end of file
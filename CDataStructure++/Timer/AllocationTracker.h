@@ -0,0 +1,34 @@
+#pragma once
+
+#include <MemoryUsage.h>
+#include <cstddef>
+
+/*
+* Counts every heap allocation of the program by replacing the global operator new and delete. Only compiled in with
+* ALLOCATION_TRACKING (cmake -DENABLE_ALLOCATION_TRACKING=ON) for benchmark builds, since every allocation pays for a
+* size header and a few atomic updates. Without it the counters stay 0 and isEnabled() is false.
+*
+* Unlike valgrind this runs at full speed on production-sized data, e.g. resetPeak() before building a container
+* and getUsage() afterwards gives the bytes it holds and the peak of temporary buffers on the way.
+*/
+class AllocationTracker
+{
+public:
+	static constexpr bool isEnabled()
+	{
+#if defined(ALLOCATION_TRACKING)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// live allocations, live and peak bytes of the whole program, elements is 0
+	static MemoryUsage getUsage();
+
+	// allocations since the start of the program, including the ones freed again
+	static size_t getTotalAllocations();
+
+	// restarts the peak at the current live bytes
+	static void resetPeak();
+};
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+namespace
+{
+	// names are written as JSON strings and CSV fields, quotes and backslashes have to be escaped
+	std::string escapeName(const std::string& name, const char quoteEscape)
+	{
+		std::string escaped;
+		for (const char c : name)
+		{
+			if (c == '"' || (quoteEscape == '\\' && c == '\\'))
+				escaped.push_back(quoteEscape);
+			escaped.push_back(c);
+		}
+		return escaped;
+	}
+}
+
+Benchmark::Benchmark(const size_t warmupSamples, const size_t sampleCount, const bool countEvents)
+	:
+	warmupSamples(warmupSamples),
+	sampleCount(sampleCount == 0 ? 1 : sampleCount),
+	counters(countEvents ? std::make_unique<PerfCounters>() : nullptr)
+{
+	if (counters && !counters->isAnyAvailable())
+		std::cerr << "Performance counters unavailable, only the runtime is measured\n";
+}
+
+void Benchmark::computeStatistics(BenchmarkResult& result)
+{
+	std::vector<double> sorted = result.samples;
+	std::sort(sorted.begin(), sorted.end());
+	const size_t count = sorted.size();
+
+	result.min = sorted.front();
+	result.max = sorted.back();
+	result.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(count);
+	result.median = count % 2 == 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+	// nearest rank: the smallest sample that is not below 99% of all samples
+	const size_t p99Rank = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(count)));
+	result.p99 = sorted[std::max<size_t>(p99Rank, 1) - 1];
+
+	double squaredDeviations = 0;
+	for (const double sample : sorted)
+	{
+		squaredDeviations += (sample - result.mean) * (sample - result.mean);
+	}
+	result.stddev = count > 1 ? std::sqrt(squaredDeviations / static_cast<double>(count - 1)) : 0;
+}
+
+void Benchmark::printSummary(std::ostream& out) const
+{
+	const std::ios::fmtflags flags = out.flags();
+	out << std::left << std::setw(48) << "benchmark (ns per call)" << std::right
+		<< std::setw(12) << "mean" << std::setw(12) << "median" << std::setw(12) << "p99"
+		<< std::setw(12) << "stddev" << std::setw(9) << "cv %" << "\n";
+	out << std::fixed << std::setprecision(1);
+	for (const BenchmarkResult& result : results)
+	{
+		const double cv = result.mean > 0 ? 100 * result.stddev / result.mean : 0;
+		out << std::left << std::setw(48) << result.name << std::right
+			<< std::setw(12) << result.mean << std::setw(12) << result.median << std::setw(12) << result.p99
+			<< std::setw(12) << result.stddev << std::setw(9) << cv << "\n";
+
+		// the counted events per call on a second line
+		bool anyEvent = false;
+		for (size_t event = 0; event < PerfCounters::EVENT_COUNT; ++event)
+		{
+			if (result.events[event] < 0)
+				continue;
+			out << (anyEvent ? ", " : "    per call: ") << PerfCounters::getName(static_cast<PerfCounters::Event>(event))
+				<< " " << result.events[event];
+			anyEvent = true;
+		}
+		if (anyEvent)
+			out << "\n";
+	}
+	out.flags(flags);
+}
+
+void Benchmark::writeJson(std::ostream& out) const
+{
+	out << "{\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchmarkResult& result = results[i];
+		out << "    {\"name\": \"" << escapeName(result.name, '\\') << "\""
+			<< ", \"iterations\": " << result.iterations
+			<< ", \"samples\": " << result.samples.size()
+			<< ", \"mean_ns\": " << result.mean
+			<< ", \"median_ns\": " << result.median
+			<< ", \"p99_ns\": " << result.p99
+			<< ", \"stddev_ns\": " << result.stddev
+			<< ", \"min_ns\": " << result.min
+			<< ", \"max_ns\": " << result.max;
+		for (size_t event = 0; event < PerfCounters::EVENT_COUNT; ++event)
+		{
+			if (result.events[event] >= 0)
+				out << ", \"" << PerfCounters::getKey(static_cast<PerfCounters::Event>(event)) << "_per_call\": " << result.events[event];
+		}
+		out << "}"
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n}\n";
+}
+
+void Benchmark::writeCsv(std::ostream& out) const
+{
+	out << "name,iterations,samples,mean_ns,median_ns,p99_ns,stddev_ns,min_ns,max_ns";
+	for (size_t event = 0; event < PerfCounters::EVENT_COUNT; ++event)
+	{
+		out << "," << PerfCounters::getKey(static_cast<PerfCounters::Event>(event)) << "_per_call";
+	}
+	out << "\n";
+	for (const BenchmarkResult& result : results)
+	{
+		out << "\"" << escapeName(result.name, '"') << "\","
+			<< result.iterations << "," << result.samples.size() << ","
+			<< result.mean << "," << result.median << "," << result.p99 << ","
+			<< result.stddev << "," << result.min << "," << result.max;
+		// unavailable events stay empty
+		for (size_t event = 0; event < PerfCounters::EVENT_COUNT; ++event)
+		{
+			out << ",";
+			if (result.events[event] >= 0)
+				out << result.events[event];
+		}
+		out << "\n";
+	}
+}
\ No newline at end of file
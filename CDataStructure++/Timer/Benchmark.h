@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Timer.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+* Keeps the compiler from optimizing away the computation of value, e.g. the result of a search whose result is
+* otherwise unused.
+*/
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	const volatile char* escaped = reinterpret_cast<const volatile char*>(&value);
+	(void)*escaped;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/*
+* Forces all pending writes to memory, so stores in the measured code are not moved out of it or dropped.
+*/
+inline void clobberMemory()
+{
+#if defined(_MSC_VER)
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : : "memory");
+#endif
+}
+
+struct BenchmarkResult
+{
+	std::string name;
+	size_t iterations = 0;		// calls of the function per sample
+	std::vector<double> samples; // nanoseconds per call, one value per sample
+	double mean = 0;
+	double median = 0;
+	double p99 = 0;
+	double stddev = 0;
+	double min = 0;
+	double max = 0;
+	// mean count per call of every event of PerfCounters, negative if the counter is unavailable
+	std::array<double, PerfCounters::EVENT_COUNT> events;
+};
+
+/*
+* Statistical micro benchmark on top of Timer: every run first calls the function for a few warmup samples that are
+* thrown away (caches, branch predictors and the allocator settle), then takes a number of samples of iterations
+* calls each. A sample is reported per call, so that short functions are timed over many calls.
+* Results are collected and can be printed as table or written as JSON or CSV.
+* With countEvents = true, the hardware counters of PerfCounters are read around every sample as well and reported
+* per call next to the time, e.g. to tell cache misses from branch mispredictions.
+*/
+class Benchmark
+{
+public:
+	explicit Benchmark(const size_t warmupSamples = 3, const size_t sampleCount = 30, const bool countEvents = false);
+
+	template<typename Function>
+	const BenchmarkResult& run(const std::string& name, Function&& function, const size_t iterations = 1)
+	{
+		BenchmarkResult result;
+		result.name = name;
+		result.iterations = iterations == 0 ? 1 : iterations;
+		result.samples.reserve(sampleCount);
+		std::array<uint64_t, PerfCounters::EVENT_COUNT> eventCounts{};
+		for (size_t sample = 0; sample < warmupSamples + sampleCount; ++sample)
+		{
+			if (counters)
+				counters->start();
+			Timer timer(false);
+			for (size_t i = 0; i < result.iterations; ++i)
+			{
+				function();
+			}
+			clobberMemory();
+			const long long elapsed = timer.ElapsedNanoseconds();
+			if (counters)
+				counters->stop();
+
+			if (sample >= warmupSamples)
+			{
+				result.samples.push_back(static_cast<double>(elapsed) / static_cast<double>(result.iterations));
+				for (size_t event = 0; counters && event < PerfCounters::EVENT_COUNT; ++event)
+				{
+					eventCounts[event] += counters->getCount(static_cast<PerfCounters::Event>(event));
+				}
+			}
+		}
+		computeStatistics(result);
+		for (size_t event = 0; event < PerfCounters::EVENT_COUNT; ++event)
+		{
+			const bool available = counters && counters->isAvailable(static_cast<PerfCounters::Event>(event));
+			result.events[event] = available
+				? static_cast<double>(eventCounts[event]) / static_cast<double>(result.iterations * sampleCount)
+				: -1;
+		}
+		results.push_back(std::move(result));
+		return results.back();
+	}
+
+	const std::vector<BenchmarkResult>& getResults() const
+	{
+		return results;
+	}
+
+	void printSummary(std::ostream& out) const;
+	void writeJson(std::ostream& out) const;
+	void writeCsv(std::ostream& out) const;
+
+private:
+	static void computeStatistics(BenchmarkResult& result);
+
+private:
+	size_t warmupSamples;
+	size_t sampleCount;
+	std::unique_ptr<PerfCounters> counters; // nullptr if events are not counted
+	std::vector<BenchmarkResult> results;
+};
\ No newline at end of file
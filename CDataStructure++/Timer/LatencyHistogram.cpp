@@ -0,0 +1,167 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <utility>
+
+LatencyHistogram::LatencyHistogram(const uint64_t highestTrackableValue, const int significantDigits)
+	:
+	highestTrackableValue(std::max<uint64_t>(highestTrackableValue, 2)),
+	significantDigits(std::min(std::max(significantDigits, 1), 5))
+{
+	// a sub-bucket count of 2 * 10^digits keeps the relative error of any value below 10^-digits
+	const double largestValueWithSingleUnitResolution = 2 * std::pow(10.0, this->significantDigits);
+	const int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(largestValueWithSingleUnitResolution)));
+	subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+	const size_t subBucketCount = size_t(1) << subBucketCountMagnitude;
+	subBucketHalfCount = subBucketCount / 2;
+	subBucketMask = (static_cast<uint64_t>(subBucketCount) - 1) << unitMagnitude;
+	leadingZeroCountBase = 64 - unitMagnitude - subBucketCountMagnitude;
+
+	// every bucket covers twice the range of the one before with the same amount of sub-buckets
+	size_t bucketCount = 1;
+	uint64_t smallestUntrackableValue = static_cast<uint64_t>(subBucketCount) << unitMagnitude;
+	while (smallestUntrackableValue <= this->highestTrackableValue)
+	{
+		++bucketCount;
+		if (smallestUntrackableValue > UINT64_MAX / 2)
+			break;
+		smallestUntrackableValue <<= 1;
+	}
+	counts.assign((bucketCount + 1) * subBucketHalfCount, 0);
+}
+
+void LatencyHistogram::recordValues(const uint64_t value, const uint64_t count)
+{
+	if (count == 0)
+		return;
+	counts[countsIndex(value)] += count;
+	totalCount += count;
+	minValue = std::min(minValue, value);
+	maxValue = std::max(maxValue, value);
+}
+
+void LatencyHistogram::recordCorrectedValue(const uint64_t value, const uint64_t expectedInterval)
+{
+	recordValue(value);
+	if (expectedInterval == 0 || value <= expectedInterval)
+		return;
+
+	for (uint64_t missedValue = value - expectedInterval; missedValue >= expectedInterval; missedValue -= expectedInterval)
+	{
+		recordValue(missedValue);
+	}
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other)
+{
+	if (other.totalCount == 0)
+		return;
+
+	if (other.highestTrackableValue == highestTrackableValue && other.significantDigits == significantDigits)
+	{
+		for (size_t i = 0; i < counts.size(); ++i)
+		{
+			counts[i] += other.counts[i];
+		}
+		totalCount += other.totalCount;
+		minValue = std::min(minValue, other.minValue);
+		maxValue = std::max(maxValue, other.maxValue);
+		return;
+	}
+
+	for (size_t i = 0; i < other.counts.size(); ++i)
+	{
+		if (other.counts[i] != 0)
+			recordValues(other.valueFromIndex(i), other.counts[i]);
+	}
+	// the exact extremes are known, not only their buckets
+	minValue = std::min(minValue, other.minValue);
+	maxValue = std::max(maxValue, other.maxValue);
+}
+
+void LatencyHistogram::reset()
+{
+	std::fill(counts.begin(), counts.end(), 0);
+	totalCount = 0;
+	minValue = UINT64_MAX;
+	maxValue = 0;
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(const double percentile) const
+{
+	if (totalCount == 0)
+		return 0;
+
+	const double clampedPercentile = std::min(std::max(percentile, 0.0), 100.0);
+	const uint64_t countAtPercentile = std::max<uint64_t>(
+		static_cast<uint64_t>(std::ceil(clampedPercentile / 100 * static_cast<double>(totalCount))), 1);
+
+	uint64_t cumulativeCount = 0;
+	for (size_t i = 0; i < counts.size(); ++i)
+	{
+		cumulativeCount += counts[i];
+		if (cumulativeCount >= countAtPercentile)
+			return std::min(highestEquivalentValue(valueFromIndex(i)), maxValue);
+	}
+	return maxValue;
+}
+
+double LatencyHistogram::getMean() const
+{
+	if (totalCount == 0)
+		return 0;
+
+	// every bucket counts with its middle value
+	double sum = 0;
+	for (size_t i = 0; i < counts.size(); ++i)
+	{
+		if (counts[i] != 0)
+		{
+			const uint64_t lowestValue = valueFromIndex(i);
+			const double middleValue = (static_cast<double>(lowestValue) + static_cast<double>(highestEquivalentValue(lowestValue))) / 2;
+			sum += middleValue * static_cast<double>(counts[i]);
+		}
+	}
+	return sum / static_cast<double>(totalCount);
+}
+
+void LatencyHistogram::printPercentiles(std::ostream& out) const
+{
+	static const std::pair<const char*, double> PERCENTILES[] = {
+		{"p50", 50}, {"p90", 90}, {"p99", 99}, {"p99.9", 99.9}, {"p99.99", 99.99}, {"max", 100}
+	};
+
+	const std::ios::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(3);
+	out << "count " << totalCount << ", mean " << getMean() / 1000 << "us";
+	for (const auto& percentile : PERCENTILES)
+	{
+		out << ", " << percentile.first << " " << static_cast<double>(getValueAtPercentile(percentile.second)) / 1000 << "us";
+	}
+	out << "\n";
+	out.flags(flags);
+	out.precision(precision);
+}
+
+uint64_t LatencyHistogram::valueFromIndex(const size_t countsIdx) const
+{
+	int bucketIdx = static_cast<int>(countsIdx >> subBucketHalfCountMagnitude) - 1;
+	size_t subBucketIdx = (countsIdx & (subBucketHalfCount - 1)) + subBucketHalfCount;
+	// the first bucket also uses its lower half
+	if (bucketIdx < 0)
+	{
+		subBucketIdx -= subBucketHalfCount;
+		bucketIdx = 0;
+	}
+	return static_cast<uint64_t>(subBucketIdx) << (bucketIdx + unitMagnitude);
+}
+
+uint64_t LatencyHistogram::highestEquivalentValue(const uint64_t value) const
+{
+	const int bucketIdx = leadingZeroCountBase - countLeadingZeros(value | subBucketMask);
+	const uint64_t bucketWidth = uint64_t(1) << (bucketIdx + unitMagnitude);
+	return value - (value & (bucketWidth - 1)) + bucketWidth - 1;
+}
\ No newline at end of file
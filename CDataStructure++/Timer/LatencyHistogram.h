@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+/*
+* High Dynamic Range histogram of latencies in nanoseconds (after Gil Tene's HdrHistogram). Every value from 1 up to
+* highestTrackableValue is recorded with a fixed relative precision of significantDigits decimal digits, so the
+* error at p99.9 of a 3 ms tail is as small as at the 200 ns median. Recording is O(1) (a leading zero count, a
+* shift and an increment) and the memory is fixed, e.g. about 270 KB for 1 hour at 3 digits.
+*
+* A histogram is not synchronized: record on one histogram per thread and merge them with add afterwards.
+* Values above highestTrackableValue are recorded as highestTrackableValue.
+*/
+class LatencyHistogram
+{
+public:
+	// one hour in nanoseconds
+	static constexpr uint64_t DEFAULT_HIGHEST_TRACKABLE_VALUE = 3600ull * 1000 * 1000 * 1000;
+
+public:
+	explicit LatencyHistogram(const uint64_t highestTrackableValue = DEFAULT_HIGHEST_TRACKABLE_VALUE, const int significantDigits = 3);
+
+	void recordValue(const uint64_t value)
+	{
+		++counts[countsIndex(value)];
+		++totalCount;
+		minValue = value < minValue ? value : minValue;
+		maxValue = value > maxValue ? value : maxValue;
+	}
+
+	void recordValues(const uint64_t value, const uint64_t count);
+
+	/*
+	* Records value, and if it is larger than expectedInterval also the values of the requests that would have been
+	* sent in the meantime and had to wait (value - expectedInterval, value - 2 * expectedInterval, ...). This
+	* corrects the coordinated omission of a load generator that waits for every response before it sends the next
+	* request at the fixed expectedInterval.
+	*/
+	void recordCorrectedValue(const uint64_t value, const uint64_t expectedInterval);
+
+	/*
+	* Adds all values of other, e.g. the histogram of another thread. Histograms with a different range or precision
+	* are merged value by value with the precision of this histogram.
+	*/
+	void add(const LatencyHistogram& other);
+
+	void reset();
+
+	/*
+	* The value that percentile percent (0 to 100) of all recorded values are smaller or equal to, within the
+	* precision of the histogram. 0 if nothing was recorded.
+	*/
+	uint64_t getValueAtPercentile(const double percentile) const;
+
+	uint64_t getTotalCount() const
+	{
+		return totalCount;
+	}
+
+	uint64_t getMin() const
+	{
+		return totalCount == 0 ? 0 : minValue;
+	}
+
+	uint64_t getMax() const
+	{
+		return maxValue;
+	}
+
+	double getMean() const;
+
+	// prints count, mean and the percentiles up to p99.99 in microseconds
+	void printPercentiles(std::ostream& out) const;
+
+private:
+	size_t countsIndex(uint64_t value) const
+	{
+		if (value > highestTrackableValue)
+			value = highestTrackableValue;
+		const int bucketIdx = leadingZeroCountBase - countLeadingZeros(value | subBucketMask);
+		const size_t subBucketIdx = static_cast<size_t>(value >> (bucketIdx + unitMagnitude));
+		return (static_cast<size_t>(bucketIdx + 1) << subBucketHalfCountMagnitude) + subBucketIdx - subBucketHalfCount;
+	}
+
+	// the smallest value of the bucket at countsIdx
+	uint64_t valueFromIndex(const size_t countsIdx) const;
+	// the largest value that is recorded into the same bucket as value
+	uint64_t highestEquivalentValue(const uint64_t value) const;
+
+	static inline int countLeadingZeros(const uint64_t value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_clzll(value);
+#else
+		int count = 0;
+		for (uint64_t bit = uint64_t(1) << 63; (value & bit) == 0; bit >>= 1)
+			++count;
+		return count;
+#endif
+	}
+
+private:
+	uint64_t highestTrackableValue;
+	int significantDigits;
+	int unitMagnitude = 0; // the lowest trackable value is 1
+	int subBucketHalfCountMagnitude;
+	size_t subBucketHalfCount;
+	uint64_t subBucketMask;
+	int leadingZeroCountBase;
+	std::vector<uint64_t> counts;
+	uint64_t totalCount = 0;
+	uint64_t minValue = UINT64_MAX;
+	uint64_t maxValue = 0;
+};
+
+/*
+* Low-overhead variant of Timer for latency histograms: no printing and no counters, only two reads of the steady
+* clock (a few ns through the vDSO on Linux) and one recordValue.
+*/
+class LatencyTimer
+{
+public:
+	explicit LatencyTimer(LatencyHistogram& histogram)
+		:
+		histogram(histogram),
+		start(now())
+	{
+	}
+
+	~LatencyTimer()
+	{
+		histogram.recordValue(now() - start);
+	}
+
+	LatencyTimer(const LatencyTimer&) = delete;
+	LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+	// nanoseconds of the steady clock
+	static uint64_t now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+private:
+	LatencyHistogram& histogram;
+	uint64_t start;
+};
\ No newline at end of file
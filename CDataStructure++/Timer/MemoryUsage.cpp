@@ -0,0 +1 @@
+#include <MemoryUsage.h>
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+/*
+* Heap memory held by a container (memoryUsage()) or by the whole program (AllocationTracker::getUsage()).
+* Bytes are the requested sizes, the overhead of the malloc implementation is not included.
+*
+* A container only knows what it holds now, its peakBytes stays 0. The peak of building or changing a container
+* (including temporary buffers) is measured with AllocationTracker::resetPeak() before and getUsage() after.
+*/
+struct MemoryUsage
+{
+	size_t allocations = 0;	// live heap blocks
+	size_t bytesLive = 0;
+	size_t peakBytes = 0;	// high-water mark since AllocationTracker::resetPeak(), 0 for containers
+	size_t elements = 0;
+
+	double getBytesPerElement() const
+	{
+		return elements == 0 ? 0.0 : static_cast<double>(bytesLive) / static_cast<double>(elements);
+	}
+
+	MemoryUsage& operator+=(const MemoryUsage& other)
+	{
+		allocations += other.allocations;
+		bytesLive += other.bytesLive;
+		peakBytes += other.peakBytes;
+		elements += other.elements;
+		return *this;
+	}
+
+	void print(std::ostream& out) const
+	{
+		out << "allocations " << allocations << ", live " << bytesLive << " B";
+		if (peakBytes != 0)
+			out << ", peak " << peakBytes << " B";
+		if (elements != 0)
+			out << ", " << elements << " elements, " << getBytesPerElement() << " B/element";
+		out << "\n";
+	}
+};
\ No newline at end of file
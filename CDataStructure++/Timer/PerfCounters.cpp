@@ -0,0 +1,146 @@
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+	constexpr uint64_t cacheMissConfig(const uint64_t cache)
+	{
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+
+	int openEvent(const uint32_t type, const uint64_t config)
+	{
+		perf_event_attr attributes;
+		std::memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = type;
+		attributes.config = config;
+		attributes.disabled = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// this thread, any CPU, no group
+		return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+	}
+}
+
+PerfCounters::PerfCounters()
+{
+	fileDescriptors[CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	fileDescriptors[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	fileDescriptors[L1D_MISSES] = openEvent(PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D));
+	fileDescriptors[LLC_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	fileDescriptors[BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	fileDescriptors[DTLB_MISSES] = openEvent(PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_DTLB));
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (const int fileDescriptor : fileDescriptors)
+	{
+		if (fileDescriptor >= 0)
+			close(fileDescriptor);
+	}
+}
+
+void PerfCounters::start()
+{
+	for (const int fileDescriptor : fileDescriptors)
+	{
+		if (fileDescriptor >= 0)
+		{
+			ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void PerfCounters::stop()
+{
+	for (const int fileDescriptor : fileDescriptors)
+	{
+		if (fileDescriptor >= 0)
+			ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+	}
+	for (size_t event = 0; event < EVENT_COUNT; ++event)
+	{
+		counts[event] = 0;
+		// value, time enabled, time running
+		uint64_t values[3] = {};
+		if (fileDescriptors[event] < 0 || read(fileDescriptors[event], values, sizeof(values)) != sizeof(values))
+			continue;
+
+		if (values[2] > 0 && values[2] < values[1])
+			counts[event] = static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+		else
+			counts[event] = values[0];
+	}
+}
+#else
+PerfCounters::PerfCounters()
+{
+	fileDescriptors.fill(-1);
+}
+
+PerfCounters::~PerfCounters()
+{
+}
+
+void PerfCounters::start()
+{
+}
+
+void PerfCounters::stop()
+{
+}
+#endif
+
+bool PerfCounters::isAnyAvailable() const
+{
+	for (size_t event = 0; event < EVENT_COUNT; ++event)
+	{
+		if (isAvailable(static_cast<Event>(event)))
+			return true;
+	}
+	return false;
+}
+
+const char* PerfCounters::getName(const Event event)
+{
+	static const char* const NAMES[EVENT_COUNT] = {
+		"cycles", "instructions", "L1d misses", "LLC misses", "branch misses", "dTLB misses"
+	};
+	return NAMES[event];
+}
+
+const char* PerfCounters::getKey(const Event event)
+{
+	static const char* const KEYS[EVENT_COUNT] = {
+		"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+	};
+	return KEYS[event];
+}
+
+void PerfCounters::print(std::ostream& out) const
+{
+	if (!isAnyAvailable())
+	{
+		out << "Performance counters unavailable\n";
+		return;
+	}
+
+	for (size_t event = 0; event < EVENT_COUNT; ++event)
+	{
+		if (isAvailable(static_cast<Event>(event)))
+			out << getName(static_cast<Event>(event)) << ": " << counts[event] << "  ";
+	}
+	if (isAvailable(CYCLES) && isAvailable(INSTRUCTIONS) && counts[CYCLES] > 0)
+		out << "IPC: " << static_cast<double>(counts[INSTRUCTIONS]) / static_cast<double>(counts[CYCLES]);
+	out << "\n";
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/*
+* Hardware performance counters of the calling thread, read with perf_event_open on Linux. Every counter is opened
+* on its own, so a counter the CPU, the kernel (perf_event_paranoid) or a container does not allow is only marked
+* unavailable and the others still count. On other platforms no counter is available.
+* Counts only user space. If the kernel has to multiplex the counters, the counts are scaled up to the full time.
+*/
+class PerfCounters
+{
+public:
+	enum Event
+	{
+		CYCLES,
+		INSTRUCTIONS,
+		L1D_MISSES,
+		LLC_MISSES,
+		BRANCH_MISSES,
+		DTLB_MISSES,
+		EVENT_COUNT
+	};
+
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	// Delete constructors which may cause headache and bugs
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// resets and starts every available counter
+	void start();
+	// stops the counters and reads them, see getCount
+	void stop();
+
+	bool isAvailable(const Event event) const
+	{
+		return fileDescriptors[event] >= 0;
+	}
+
+	bool isAnyAvailable() const;
+
+	// count between the last start and stop, 0 if the counter is unavailable
+	uint64_t getCount(const Event event) const
+	{
+		return counts[event];
+	}
+
+	static const char* getName(const Event event);
+	// name for machine-readable output, e.g. l1d_misses
+	static const char* getKey(const Event event);
+
+	// prints every available count and the instructions per cycle
+	void print(std::ostream& out) const;
+
+private:
+	std::array<int, EVENT_COUNT> fileDescriptors;
+	std::array<uint64_t, EVENT_COUNT> counts{};
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "TeardownQueue.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace
+{
+	class TeardownWorker
+	{
+	public:
+		TeardownWorker()
+			:
+			thread([this]() { run(); })
+		{
+		}
+
+		TeardownWorker(const TeardownWorker&) = delete;
+		TeardownWorker& operator=(const TeardownWorker&) = delete;
+
+		// runs during static destruction, the queue is drained before the thread ends
+		~TeardownWorker()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wakeUp.notify_one();
+			thread.join();
+		}
+
+		std::future<void> enqueue(std::function<void()> task)
+		{
+			std::packaged_task<void()> packagedTask(std::move(task));
+			std::future<void> done = packagedTask.get_future();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.push_back(std::move(packagedTask));
+			}
+			wakeUp.notify_one();
+			return done;
+		}
+
+	private:
+		void run()
+		{
+			while (true)
+			{
+				std::packaged_task<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wakeUp.wait(lock, [this]() { return stopping || !tasks.empty(); });
+					if (tasks.empty())
+						return;
+					task = std::move(tasks.front());
+					tasks.pop_front();
+				}
+				task();
+			}
+		}
+
+	private:
+		std::mutex mutex;
+		std::condition_variable wakeUp;
+		std::deque<std::packaged_task<void()>> tasks;
+		bool stopping = false;
+		std::thread thread; // last member, it starts running once everything else is constructed
+	};
+}
+
+std::future<void> TeardownQueue::enqueue(std::function<void()> task)
+{
+	static TeardownWorker worker;
+	return worker.enqueue(std::move(task));
+}
\ No newline at end of file
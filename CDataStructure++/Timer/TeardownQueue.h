@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <future>
+
+/*
+* One shared background thread that runs the deferred teardown of clearDeferred (AVLTree, BinarySearchTree,
+* LinkedList) in the order it was queued. The thread is joined when the program exits, after the queued teardowns
+* are done, so a dropped future can't leave a thread freeing nodes while static objects are destroyed.
+*/
+class TeardownQueue
+{
+public:
+	// the future is ready once task has run
+	static std::future<void> enqueue(std::function<void()> task);
+};
\ No newline at end of file
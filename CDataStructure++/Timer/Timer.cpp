@@ -5,14 +5,30 @@ Timer::Timer()
 	m_Start = std::chrono::high_resolution_clock::now();
 }
 
+Timer::Timer(const bool print, const bool countEvents)
+	:
+	m_Print(print)
+{
+	// opening the counters is a system call per event, it is done before the measured scope starts
+	if (countEvents)
+	{
+		m_Counters = std::make_unique<PerfCounters>();
+		m_Counters->start();
+	}
+	m_Start = std::chrono::high_resolution_clock::now();
+}
+
 Timer::~Timer()
 {
-	Stop();
+	if (m_Print)
+		Stop();
 }
 
 void Timer::Stop()
 {
 	m_End = std::chrono::high_resolution_clock::now();
+	if (m_Counters)
+		m_Counters->stop();
 	
 	auto start = std::chrono::time_point_cast<std::chrono::microseconds>(m_Start).time_since_epoch().count();
 	auto end = std::chrono::time_point_cast<std::chrono::microseconds>(m_End).time_since_epoch().count();
@@ -21,4 +37,23 @@ void Timer::Stop()
 	double millis = durationMicroSeconds * 0.001;
 
 	std::cout << "Runtime taken: " << durationMicroSeconds << "us (" << millis << "ms)\n";
+	if (m_Counters)
+		m_Counters->print(std::cout);
+}
+
+void Timer::Restart()
+{
+	if (m_Counters)
+		m_Counters->start();
+	m_Start = std::chrono::high_resolution_clock::now();
+}
+
+long long Timer::ElapsedNanoseconds() const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - m_Start).count();
+}
+
+const PerfCounters* Timer::Counters() const
+{
+	return m_Counters.get();
 }
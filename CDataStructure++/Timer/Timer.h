@@ -2,17 +2,29 @@
 
 #include <iostream>
 #include <chrono>
+#include <memory>
+#include "PerfCounters.h"
 	
 /*
 * Credits to The Cherno for this class
+* A silent Timer (print = false) only measures, see ElapsedNanoseconds, which is what Benchmark builds on.
+* With countEvents = true the Timer also counts cycles, instructions and cache, branch and TLB misses of the scope
+* (see PerfCounters) and prints them with the runtime. Without counter support only the runtime is measured.
  */
 class Timer
 {
 public:
 	Timer();
+	explicit Timer(const bool print, const bool countEvents = false);
 	~Timer();
 	void Stop();
+	void Restart();
+	long long ElapsedNanoseconds() const;
+	// nullptr if the Timer does not count events, the counts are read by Stop
+	const PerfCounters* Counters() const;
 private:
 	std::chrono::time_point< std::chrono::high_resolution_clock> m_Start;
 	std::chrono::time_point< std::chrono::high_resolution_clock> m_End;
+	bool m_Print = true;
+	std::unique_ptr<PerfCounters> m_Counters;
 };
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "Trace.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	/*
+	* Ring buffer of one thread. Only the owning thread writes, so recording is a few relaxed stores and one release
+	* store of the head. The fields are atomic because writeChromeJson may read a slot while it is overwritten, such
+	* a slot is detected by reading the head again and skipped.
+	*/
+	struct TraceBuffer
+	{
+		struct Event
+		{
+			std::atomic<const char*> name{nullptr};
+			std::atomic<uint64_t> beginNanoseconds{0};
+			std::atomic<uint64_t> endNanoseconds{0};
+		};
+
+		explicit TraceBuffer(const size_t threadId)
+			:
+			threadId(threadId),
+			events(new Event[Trace::BUFFER_CAPACITY])
+		{
+		}
+
+		const size_t threadId;
+		std::unique_ptr<Event[]> events;
+		std::atomic<uint64_t> head{0};	// amount of events ever recorded
+		std::atomic<uint64_t> tail{0};	// events before tail are cleared
+		bool inUse = true;				// owned by a running thread, guarded by the registry mutex
+	};
+
+	// all buffers ever registered, so a flush can also read the events of finished threads. The registry is never
+	// destroyed, threads that still record during static destruction (e.g. a teardown thread) would use it after free
+	std::mutex& getRegistryMutex()
+	{
+		static std::mutex* registryMutex = new std::mutex();
+		return *registryMutex;
+	}
+
+	std::vector<std::unique_ptr<TraceBuffer>>& getRegistry()
+	{
+		static std::vector<std::unique_ptr<TraceBuffer>>* registry = new std::vector<std::unique_ptr<TraceBuffer>>();
+		return *registry;
+	}
+
+	/*
+	* The buffer of the current thread. A finished thread gives its buffer back and the next new thread continues
+	* recording into it, so the amount of buffers is the maximum amount of threads recording at the same time
+	* instead of growing with every std::async task and teardown thread.
+	*/
+	class BufferLease
+	{
+	public:
+		BufferLease() = default;
+		BufferLease(const BufferLease&) = delete;
+		BufferLease& operator=(const BufferLease&) = delete;
+
+		~BufferLease()
+		{
+			if (buffer != nullptr)
+			{
+				std::lock_guard<std::mutex> lock(getRegistryMutex());
+				buffer->inUse = false;
+			}
+		}
+
+		TraceBuffer& get()
+		{
+			if (buffer == nullptr)
+				buffer = acquire();
+			return *buffer;
+		}
+
+	private:
+		static TraceBuffer* acquire()
+		{
+			std::lock_guard<std::mutex> lock(getRegistryMutex());
+			for (const std::unique_ptr<TraceBuffer>& registered : getRegistry())
+			{
+				if (!registered->inUse)
+				{
+					registered->inUse = true;
+					return registered.get();
+				}
+			}
+			getRegistry().push_back(std::make_unique<TraceBuffer>(getRegistry().size() + 1));
+			return getRegistry().back().get();
+		}
+
+	private:
+		TraceBuffer* buffer = nullptr;
+	};
+
+	TraceBuffer& getThreadBuffer()
+	{
+		thread_local BufferLease lease;
+		return lease.get();
+	}
+
+	void writeEscaped(std::ostream& out, const char* name)
+	{
+		for (; *name != '\0'; ++name)
+		{
+			if (*name == '"' || *name == '\\')
+				out << '\\';
+			out << *name;
+		}
+	}
+}
+
+void Trace::record(const char* name, const uint64_t beginNanoseconds, const uint64_t endNanoseconds)
+{
+	TraceBuffer& buffer = getThreadBuffer();
+	const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+	TraceBuffer::Event& event = buffer.events[head & (BUFFER_CAPACITY - 1)];
+	// a reader that sees any of the following stores also sees the head of the previous event, see writeChromeJson
+	std::atomic_thread_fence(std::memory_order_release);
+	event.name.store(name, std::memory_order_relaxed);
+	event.beginNanoseconds.store(beginNanoseconds, std::memory_order_relaxed);
+	event.endNanoseconds.store(endNanoseconds, std::memory_order_relaxed);
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+size_t Trace::writeChromeJson(std::ostream& out)
+{
+	std::lock_guard<std::mutex> lock(getRegistryMutex());
+	const std::ios::fmtflags flags = out.flags();
+	out << std::fixed;
+	out.precision(3);
+
+	size_t written = 0;
+	out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+	for (const std::unique_ptr<TraceBuffer>& buffer : getRegistry())
+	{
+		const uint64_t head = buffer->head.load(std::memory_order_acquire);
+		uint64_t first = buffer->tail.load(std::memory_order_relaxed);
+		if (head - first > BUFFER_CAPACITY)
+			first = head - BUFFER_CAPACITY;
+
+		for (uint64_t i = first; i < head; ++i)
+		{
+			const TraceBuffer::Event& event = buffer->events[i & (BUFFER_CAPACITY - 1)];
+			const char* name = event.name.load(std::memory_order_relaxed);
+			const uint64_t beginNanoseconds = event.beginNanoseconds.load(std::memory_order_relaxed);
+			const uint64_t endNanoseconds = event.endNanoseconds.load(std::memory_order_relaxed);
+			// the owner may have wrapped around and be overwriting the slot while it was read, then the head is
+			// already at least a full buffer ahead of the event
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (buffer->head.load(std::memory_order_relaxed) - i >= BUFFER_CAPACITY)
+				continue;
+
+			// complete events ("X") with timestamps in microseconds
+			out << (written == 0 ? "" : ",\n") << "{\"name\": \"";
+			writeEscaped(out, name);
+			out << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+				<< ", \"ts\": " << static_cast<double>(beginNanoseconds) / 1000
+				<< ", \"dur\": " << static_cast<double>(endNanoseconds - beginNanoseconds) / 1000 << "}";
+			++written;
+		}
+	}
+	out << "\n]}\n";
+	out.flags(flags);
+	return written;
+}
+
+void Trace::clear()
+{
+	std::lock_guard<std::mutex> lock(getRegistryMutex());
+	for (const std::unique_ptr<TraceBuffer>& buffer : getRegistry())
+	{
+		buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
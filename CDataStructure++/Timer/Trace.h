@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/*
+* Scoped trace events for timelines in chrome://tracing or Perfetto (ui.perfetto.dev).
+*
+* TRACE_SCOPE("AVLTree::rotateLeft") records the begin and end of the enclosing scope. Recording is lock-free: every
+* thread writes into its own ring buffer, only the first event of a thread takes a lock to register the buffer. Once
+* a buffer is full, the oldest events are overwritten and the newest BUFFER_CAPACITY - 1 events are kept (the slot
+* the owner writes next can't be read safely). Trace::writeChromeJson writes the events of all threads in the
+* Chrome trace-event format, also while other threads keep recording.
+*
+* A thread gives its buffer back when it ends and a later thread reuses it, so the memory is bounded by the amount
+* of threads recording at the same time (about 1.5 MB each). The tid of an event therefore names the buffer: threads
+* that ran one after the other can share a track in the viewer.
+*
+* Events are only recorded if compiled with TRACE_EVENTS (cmake -DENABLE_TRACE=ON), otherwise TRACE_SCOPE expands to
+* nothing and the data structures don't pay for their instrumentation. The name has to outlive the trace, e.g. a
+* string literal.
+*/
+class Trace
+{
+public:
+	// events kept per thread, a power of 2
+	static constexpr size_t BUFFER_CAPACITY = size_t(1) << 16;
+
+	// nanoseconds since the first use of the trace
+	static uint64_t now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - getEpoch()).count());
+	}
+
+	static void record(const char* name, const uint64_t beginNanoseconds, const uint64_t endNanoseconds);
+
+	/*
+	* Writes the recorded events of all threads as Chrome trace-event JSON and returns the amount of events.
+	*/
+	static size_t writeChromeJson(std::ostream& out);
+
+	// drops all recorded events, the buffers of the threads stay registered
+	static void clear();
+
+private:
+	static std::chrono::steady_clock::time_point getEpoch()
+	{
+		static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		return epoch;
+	}
+};
+
+/*
+* Records the lifetime of the object as one trace event, see TRACE_SCOPE.
+*/
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name)
+		:
+		name(name),
+		beginNanoseconds(Trace::now())
+	{
+	}
+
+	~TraceScope()
+	{
+		Trace::record(name, beginNanoseconds, Trace::now());
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name;
+	uint64_t beginNanoseconds;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#if defined(TRACE_EVENTS)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
\ No newline at end of file
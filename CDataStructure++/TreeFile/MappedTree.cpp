@@ -0,0 +1 @@
+#include <MappedTree.h>
\ No newline at end of file
@@ -0,0 +1,181 @@
+#pragma once
+#include "TreeFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Read-only view of a tree file written by AVLTree::serialize or BinarySearchTree::serialize.
+ * The file is memory mapped and searched in place, so nothing is copied or allocated per node. Opening it
+ * validates the records once in O(n), see isValidTreeFile.
+ */
+template <typename T>
+class MappedTree
+{
+	static_assert(alignof(TreeFileNode<T>) <= alignof(TreeFileHeader), "records have to be aligned behind the header");
+
+public:
+	MappedTree() = default;
+
+	// Delete constructors which may cause headache and bugs
+	MappedTree(const MappedTree &) = delete;
+	MappedTree(MappedTree &&) = delete;
+
+	~MappedTree()
+	{
+		close();
+	}
+
+	/*
+	 *	Maps the tree file at path. Returns false if it cannot be mapped or is not a valid search tree of T.
+	 */
+	bool open(const std::string &path)
+	{
+		close();
+		if (!mapFile(path))
+			return false;
+
+		const TreeFileHeader *header = static_cast<const TreeFileHeader *>(mapping);
+		if (mappingSize < sizeof(TreeFileHeader) ||
+			!header->isValid(sizeof(T)) ||
+			header->nodeCount > (mappingSize - sizeof(TreeFileHeader)) / sizeof(TreeFileNode<T>))
+		{
+			close();
+			return false;
+		}
+
+		nodeCount = static_cast<size_t>(header->nodeCount);
+		records = reinterpret_cast<const TreeFileNode<T> *>(static_cast<const char *>(mapping) + sizeof(TreeFileHeader));
+		if (!isValidTreeFile(records, nodeCount, (header->flags & TreeFileHeader::HAS_BALANCE_FACTORS) != 0))
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close()
+	{
+		unmapFile();
+		records = nullptr;
+		nodeCount = 0;
+	}
+
+	bool isOpen() const
+	{
+		return mapping != nullptr;
+	}
+
+	size_t getSize() const
+	{
+		return nodeCount;
+	}
+
+	/*
+	 *	Returns the data equal to data inside the mapped file, or nullptr if there is none.
+	 */
+	const T *searchNode(const T &data) const
+	{
+		if (nodeCount == 0)
+			return nullptr;
+
+		size_t idx = 0;
+		while (true)
+		{
+			const TreeFileNode<T> &record = records[idx];
+			if (data < record.data)
+			{
+				if (!record.hasLeft())
+					return nullptr;
+				idx = idx + 1;
+			}
+			else if (record.data < data)
+			{
+				if (!record.hasRight())
+					return nullptr;
+				idx = record.right;
+			}
+			else
+			{
+				return &record.data;
+			}
+		}
+	}
+
+private:
+#if defined(_WIN32)
+	bool mapFile(const std::string &path)
+	{
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		HANDLE fileMapping = nullptr;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+			fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (fileMapping == nullptr)
+			return false;
+
+		// the view keeps the file mapping alive
+		mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(fileMapping);
+		mappingSize = mapping != nullptr ? static_cast<size_t>(fileSize.QuadPart) : 0;
+		return mapping != nullptr;
+	}
+
+	void unmapFile()
+	{
+		if (mapping != nullptr)
+			UnmapViewOfFile(mapping);
+		mapping = nullptr;
+		mappingSize = 0;
+	}
+#else
+	bool mapFile(const std::string &path)
+	{
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat fileStat;
+		void *mapped = MAP_FAILED;
+		if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+			mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		// the mapping stays valid after closing the file
+		::close(fd);
+		if (mapped == MAP_FAILED)
+			return false;
+
+		mapping = mapped;
+		mappingSize = static_cast<size_t>(fileStat.st_size);
+		return true;
+	}
+
+	void unmapFile()
+	{
+		if (mapping != nullptr)
+			munmap(mapping, mappingSize);
+		mapping = nullptr;
+		mappingSize = 0;
+	}
+#endif
+
+private:
+	void *mapping = nullptr;
+	size_t mappingSize = 0;
+	const TreeFileNode<T> *records = nullptr;
+	size_t nodeCount = 0;
+};
@@ -0,0 +1 @@
+#include <TreeFile.h>
\ No newline at end of file
@@ -0,0 +1,214 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Binary file format of AVLTree and BinarySearchTree.
+ *
+ * After the header the nodes follow as fixed-size records in pre-order. The left child of a node is always the
+ * next record, the right child is stored as record index. Loading links the records in O(n) without comparing or
+ * rebalancing anything, and MappedTree can search the records in place without loading them.
+ * The data is stored as raw bytes in the byte order of the machine, so T has to be trivially copyable.
+ */
+struct TreeFileHeader
+{
+	static constexpr char MAGIC[4] = {'C', 'D', 'S', 'T'};
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t HAS_BALANCE_FACTORS = 0x1; // written by AVLTree
+
+	char magic[4];
+	uint32_t version;
+	uint32_t dataSize; // sizeof(T) of the writer
+	uint32_t flags;
+	uint64_t nodeCount;
+
+	bool isValid(const size_t expectedDataSize) const
+	{
+		return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && version == VERSION && dataSize == expectedDataSize;
+	}
+};
+
+template <typename T>
+struct TreeFileNode
+{
+	static constexpr uint8_t HAS_LEFT = 0x1;
+	static constexpr uint8_t HAS_RIGHT = 0x2;
+
+	T data;
+	uint32_t right;	  // record index of the right child
+	int8_t bf;		  // balance factor, 0 if the file has no balance factors
+	uint8_t children; // HAS_LEFT | HAS_RIGHT
+
+	inline bool hasLeft() const
+	{
+		return (children & HAS_LEFT) != 0;
+	}
+
+	inline bool hasRight() const
+	{
+		return (children & HAS_RIGHT) != 0;
+	}
+};
+
+/*
+ * Writes the tree below root. getBf(node) returns the balance factor stored for the node.
+ * Uses an explicit stack since a BinarySearchTree may be as deep as it has nodes.
+ */
+template <typename T, typename Node, typename GetBf>
+bool writeTreeFile(std::ostream &out, Node *root, const uint32_t flags, GetBf getBf)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable data can be written as raw bytes");
+
+	std::vector<TreeFileNode<T>> records;
+	// node to write next and the record waiting for its index as right child (or SIZE_MAX)
+	std::vector<std::pair<Node *, size_t>> pending;
+	if (root != nullptr)
+		pending.emplace_back(root, SIZE_MAX);
+
+	while (!pending.empty())
+	{
+		Node *currNode = pending.back().first;
+		const size_t parentRecord = pending.back().second;
+		pending.pop_back();
+
+		const size_t currRecord = records.size();
+		if (currRecord > UINT32_MAX)
+			return false;
+		if (parentRecord != SIZE_MAX)
+			records[parentRecord].right = static_cast<uint32_t>(currRecord);
+
+		// zero the padding as well, so that the same tree always gives the same bytes
+		TreeFileNode<T> record;
+		std::memset(static_cast<void *>(&record), 0, sizeof(record));
+		std::memcpy(static_cast<void *>(&record.data), &currNode->getData(), sizeof(T));
+		record.bf = static_cast<int8_t>(getBf(currNode));
+		record.children = (currNode->getLeft() != nullptr ? TreeFileNode<T>::HAS_LEFT : 0) |
+						  (currNode->getRight() != nullptr ? TreeFileNode<T>::HAS_RIGHT : 0);
+		records.push_back(record);
+
+		// the left subtree has to be written first, so it is pushed last
+		if (currNode->getRight() != nullptr)
+			pending.emplace_back(currNode->getRight(), currRecord);
+		if (currNode->getLeft() != nullptr)
+			pending.emplace_back(currNode->getLeft(), SIZE_MAX);
+	}
+
+	TreeFileHeader header{};
+	std::memcpy(header.magic, TreeFileHeader::MAGIC, sizeof(header.magic));
+	header.version = TreeFileHeader::VERSION;
+	header.dataSize = sizeof(T);
+	header.flags = flags;
+	header.nodeCount = records.size();
+
+	out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(TreeFileNode<T>)));
+	return static_cast<bool>(out);
+}
+
+/*
+ * Checks that the records form a single search tree of T:
+ *	- every child index points behind its parent and every record except the first one is the child of exactly
+ *	  one record,
+ *	- the data is strictly ordered, every node is larger than its left and smaller than its right subtree,
+ *	- with checkBalanceFactors, every balance factor is the height of the right minus the height of the left
+ *	  subtree and in [-1, 1].
+ * A file that passes can be linked as is without breaking the invariants the trees rely on. O(n).
+ */
+template <typename T>
+bool isValidTreeFile(const TreeFileNode<T> *records, const size_t nodeCount, const bool checkBalanceFactors)
+{
+	std::vector<bool> hasParent(nodeCount, false);
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		const size_t left = i + 1;
+		const size_t right = records[i].right;
+		if (records[i].hasLeft() && (left >= nodeCount || hasParent[left]))
+			return false;
+		if (records[i].hasLeft())
+			hasParent[left] = true;
+		if (records[i].hasRight() && (right <= i || right >= nodeCount || hasParent[right]))
+			return false;
+		if (records[i].hasRight())
+			hasParent[right] = true;
+	}
+
+	size_t childCount = 0;
+	for (size_t i = 1; i < nodeCount; ++i)
+		childCount += hasParent[i];
+	if (childCount + 1 != nodeCount && nodeCount != 0)
+		return false;
+
+	// records of the closest ancestors the data has to lie between (SIZE_MAX if unbounded), parents come
+	// before their children, so the bounds of a record are known once it is reached
+	std::vector<size_t> lowerBound(nodeCount, SIZE_MAX);
+	std::vector<size_t> upperBound(nodeCount, SIZE_MAX);
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		if ((lowerBound[i] != SIZE_MAX && !(records[lowerBound[i]].data < records[i].data)) ||
+			(upperBound[i] != SIZE_MAX && !(records[i].data < records[upperBound[i]].data)))
+			return false;
+		if (records[i].hasLeft())
+		{
+			lowerBound[i + 1] = lowerBound[i];
+			upperBound[i + 1] = i;
+		}
+		if (records[i].hasRight())
+		{
+			lowerBound[records[i].right] = i;
+			upperBound[records[i].right] = upperBound[i];
+		}
+	}
+
+	// children come behind their parents, so going backwards computes the heights bottom-up
+	std::vector<size_t> &heights = lowerBound;
+	for (size_t i = nodeCount; i-- > 0;)
+	{
+		const size_t leftHeight = records[i].hasLeft() ? heights[i + 1] : 0;
+		const size_t rightHeight = records[i].hasRight() ? heights[records[i].right] : 0;
+		if (checkBalanceFactors &&
+			(records[i].bf < -1 || records[i].bf > 1 ||
+			 static_cast<long long>(rightHeight) - static_cast<long long>(leftHeight) != records[i].bf))
+			return false;
+		heights[i] = 1 + std::max(leftHeight, rightHeight);
+	}
+	return true;
+}
+
+/*
+ * Reads the header and the records of a tree file. Returns false if the file is not a valid search tree of T
+ * (see isValidTreeFile) or misses requiredFlags.
+ */
+template <typename T>
+bool readTreeFile(std::istream &in, std::vector<TreeFileNode<T>> &records, const uint32_t requiredFlags = 0)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable data can be read as raw bytes");
+
+	TreeFileHeader header{};
+	if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+		!header.isValid(sizeof(T)) ||
+		(header.flags & requiredFlags) != requiredFlags)
+	{
+		return false;
+	}
+
+	// read in chunks, so that a corrupted node count fails at the end of the file instead of allocating it up front
+	static constexpr size_t RECORDS_PER_CHUNK = 65536;
+	records.clear();
+	while (records.size() < header.nodeCount)
+	{
+		const size_t readRecords = records.size();
+		const size_t chunkRecords = std::min<uint64_t>(RECORDS_PER_CHUNK, header.nodeCount - readRecords);
+		records.resize(readRecords + chunkRecords);
+		if (!in.read(reinterpret_cast<char *>(records.data() + readRecords), static_cast<std::streamsize>(chunkRecords * sizeof(TreeFileNode<T>))))
+			return false;
+	}
+
+	return isValidTreeFile(records.data(), records.size(), (header.flags & TreeFileHeader::HAS_BALANCE_FACTORS) != 0);
+}
@@ -0,0 +1,156 @@
+#include <Benchmark.h>
+#include <HashTable.h>
+#include <BinarySearchTree.h>
+#include <AVLTree.h>
+#include <RedBlackTree.h>
+#include <BPlusTree.h>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+/*
+* Statistical benchmarks of the data structures, see Benchmark. Unlike the one-shot Timer measurements of app, every
+* benchmark is warmed up and sampled repeatedly, so the reported median and p99 can be compared between
+* implementations and between runs. Where perf_event_open is allowed, cycles, instructions and cache, branch and TLB
+* misses per call are reported as well.
+*
+* Usage: bench [--warmup N] [--samples N] [--json FILE] [--csv FILE]
+*/
+
+namespace
+{
+	std::string randomString(std::mt19937& generator, const size_t length)
+	{
+		static const std::string charset = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890";
+		std::uniform_int_distribution<size_t> distribution(0, charset.size() - 1);
+		std::string result(length, ' ');
+		for (char& c : result)
+		{
+			c = charset[distribution(generator)];
+		}
+		return result;
+	}
+
+	void benchmarkHashTable(Benchmark& benchmark)
+	{
+		// Constants
+		static constexpr size_t KEYS = 500;
+		static constexpr size_t HASH_TABLE_CAP = 15;
+
+		std::mt19937 generator(46);
+		std::vector<std::string> keys;
+		for (size_t i = 0; i < KEYS; ++i)
+		{
+			keys.push_back(randomString(generator, 5));
+		}
+
+		benchmark.run("HashTable::put 500 keys into an empty table", [&]()
+			{
+				HashTable<std::string, size_t> ht(HASH_TABLE_CAP);
+				for (size_t i = 0; i < KEYS; ++i)
+				{
+					ht.put(keys[i], i);
+				}
+				doNotOptimize(ht);
+			}, 10);
+	}
+
+	void benchmarkTreeSearch(Benchmark& benchmark)
+	{
+		// Constants
+		static constexpr int TREE_SIZE = 1000000;
+		static constexpr size_t LOOKUPS = 1 << 16; // power of 2, the lookup keys are cycled with a mask
+		static constexpr size_t ITERATIONS = 100000;
+
+		std::mt19937 generator(46);
+		std::uniform_int_distribution<int> distribution(0, TREE_SIZE * 2);
+		std::vector<int> keys;
+		for (int i = 0; i < TREE_SIZE; ++i)
+		{
+			keys.push_back(distribution(generator));
+		}
+		std::vector<int> lookups;
+		for (size_t i = 0; i < LOOKUPS; ++i)
+		{
+			lookups.push_back(distribution(generator));
+		}
+
+		BinarySearchTree<int> bst;
+		AVLTree<int> avl;
+		RedBlackTree<int> rbt;
+		BPlusTree<int, int> bpt;
+		for (const int key : keys)
+		{
+			bst.insertNode(key);
+			avl.insertNode(key);
+			rbt.insertNode(key);
+			bpt.insertNode(key, key);
+		}
+		const FrozenAVLTree<int> frozen = avl.freeze();
+
+		size_t next = 0;
+		benchmark.run("BinarySearchTree::find random 1M", [&]()
+			{ doNotOptimize(bst.find(lookups[next++ & (LOOKUPS - 1)])); }, ITERATIONS);
+		benchmark.run("AVLTree::searchNode random 1M", [&]()
+			{ doNotOptimize(avl.searchNode(lookups[next++ & (LOOKUPS - 1)])); }, ITERATIONS);
+		benchmark.run("RedBlackTree::searchNode random 1M", [&]()
+			{ doNotOptimize(rbt.searchNode(lookups[next++ & (LOOKUPS - 1)])); }, ITERATIONS);
+		benchmark.run("FrozenAVLTree::searchNode random 1M", [&]()
+			{ doNotOptimize(frozen.searchNode(lookups[next++ & (LOOKUPS - 1)])); }, ITERATIONS);
+		benchmark.run("BPlusTree::searchNode random 1M", [&]()
+			{ doNotOptimize(bpt.searchNode(lookups[next++ & (LOOKUPS - 1)])); }, ITERATIONS);
+	}
+
+	bool writeFile(const std::string& path, const Benchmark& benchmark, void (Benchmark::*write)(std::ostream&) const)
+	{
+		std::ofstream out(path);
+		if (!out)
+		{
+			std::cerr << "cannot write " << path << "\n";
+			return false;
+		}
+		(benchmark.*write)(out);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t warmupSamples = 3;
+	size_t sampleCount = 30;
+	std::string jsonPath;
+	std::string csvPath;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--warmup")
+			warmupSamples = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--samples")
+			sampleCount = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--json")
+			jsonPath = argv[i + 1];
+		else if (option == "--csv")
+			csvPath = argv[i + 1];
+		else
+		{
+			std::cerr << "Usage: bench [--warmup N] [--samples N] [--json FILE] [--csv FILE]\n";
+			return 1;
+		}
+	}
+
+	// the hardware counters are read where the platform allows it, see PerfCounters
+	Benchmark benchmark(warmupSamples, sampleCount, true);
+	benchmarkHashTable(benchmark);
+	benchmarkTreeSearch(benchmark);
+	benchmark.printSummary(std::cout);
+
+	if (!jsonPath.empty() && !writeFile(jsonPath, benchmark, &Benchmark::writeJson))
+		return 1;
+	if (!csvPath.empty() && !writeFile(csvPath, benchmark, &Benchmark::writeCsv))
+		return 1;
+	return 0;
+}
@@ -1,14 +1,44 @@
 #include <HashTable.h>
 #include <LinkedList.h>
 #include <Timer.h>
+#include <Trace.h>
+#include <LatencyHistogram.h>
+#include <AllocationTracker.h>
 #include <BinarySearchTree.h>
+#include <SplayTree.h>
+#include <Treap.h>
+#include <ConcurrentBST.h>
 #include <AVLTree.h>
+#include <ConcurrentAVLTree.h>
+#include <PersistentAVLTree.h>
+#include <AVLMap.h>
+#include <CompactAVLTree.h>
+#include <IntervalTree.h>
+#include <MappedTree.h>
+#include <BPlusTree.h>
+#include <RedBlackTree.h>
 #include <random>
 #include <iostream>
 #include <functional>
 #include <algorithm>
 #include <exception>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <map>
+#include <set>
+#include <cstdlib>
+#include <cmath>
+#include <numeric>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 
 const std::string randomStrGen(const size_t &length, const size_t &rndNum)
 {
@@ -85,9 +115,9 @@ int testingHashTableWithBenchmark()
 			rndVals.emplace_back(roll_dice());
 		}
 
-		// Popluating Ht with benchmarking for put
+		// Popluating Ht with benchmarking for put, with hardware counters where available
 		{
-			Timer timer;
+			Timer timer(true, true);
 			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
 			{
 				ht.put(rndStrs.at(i), rndVals.at(i));
@@ -732,11 +762,2777 @@ int testAVLTreeDeletionCases()
 	return 0;
 }
 
-int main(int argc, char *argv[])
+// checks parent links, order and balance factors of every node, returns the height of the subtree
+template <typename Node>
+int checkAVLSubtree(Node *currNode, Node *parentNode, bool &isValid, std::vector<int> &inorder)
+{
+	if (currNode == nullptr)
+		return 0;
+
+	isValid = isValid && currNode->getParent() == parentNode;
+	const int leftHeight = checkAVLSubtree(currNode->getLeft(), currNode, isValid, inorder);
+	inorder.push_back(currNode->getData());
+	const int rightHeight = checkAVLSubtree(currNode->getRight(), currNode, isValid, inorder);
+	isValid = isValid && currNode->getBf() == rightHeight - leftHeight && std::abs(rightHeight - leftHeight) <= 1;
+	return std::max(leftHeight, rightHeight) + 1;
+}
+
+int testAVLTreeBatchInsertion()
+{
+	std::mt19937 generator(11);
+	std::uniform_int_distribution<int> distribution(0, 50000);
+
+	for (const bool parallel : {false, true})
+	{
+		AVLTree<int> t;
+		std::set<int> expected;
+		bool allBatchesMatch = true;
+		for (int i = 0; i < 1000; ++i)
+		{
+			const int key = distribution(generator);
+			t.insertNode(key);
+			expected.insert(key);
+		}
+
+		// a wide batch spread over the whole tree, a narrow one into a single subtree and one with duplicates only
+		std::vector<std::vector<int>> batches(3);
+		for (int i = 0; i < 20000; ++i)
+		{
+			batches[0].push_back(distribution(generator));
+			batches[1].push_back(60000 + i % 5000);
+		}
+		batches[2].assign(expected.begin(), expected.end());
+
+		for (const auto &batch : batches)
+		{
+			size_t newElements = 0;
+			for (const int key : batch)
+			{
+				newElements += expected.insert(key).second;
+			}
+			allBatchesMatch = allBatchesMatch && t.insertBatch(batch, parallel) == newElements;
+		}
+
+		bool isValid = true;
+		std::vector<int> inorder;
+		checkAVLSubtree(t.getRoot(), static_cast<AVLNode<int> *>(nullptr), isValid, inorder);
+
+		const std::string caseName = parallel ? "[BATCH CASE 2]" : "[BATCH CASE 1]";
+		if (allBatchesMatch && isValid && inorder == std::vector<int>(expected.begin(), expected.end()))
+		{
+			std::cout << caseName << " CORRECT " << (parallel ? "parallel " : "") << "batch insertion keeps the tree balanced";
+		}
+		else
+		{
+			std::cout << caseName << " INCORRECT " << (parallel ? "parallel " : "") << "batch insertion";
+		}
+		std::cout << "\n";
+	}
+
+	return 0;
+}
+
+#if defined(AVL_TREE_STATS)
+int testAVLTreeStats()
+{
+	AVLTree<int> t;
+	// ascending inserts only need left rotations
+	for (int i = 1; i <= 7; ++i)
+	{
+		t.insertNode(i);
+	}
+	t.searchNode(4);
+	t.searchNode(7);
+	t.removeNode(1);
+
+	const AVLTreeStats stats = t.getStats();
+	if (stats.rotationsLeft == 4 &&
+		stats.getTotalRotations() == 4 &&
+		stats.nodeCount == 6 &&
+		stats.height == 3 &&
+		stats.searchDepths[1] == 1 &&
+		stats.searchDepths[3] == 1 &&
+		stats.insertionWalkLengths[0] == 1 &&
+		stats.deletionWalkLengths[1] == 1)
+	{
+		std::cout << "[STATS CASE 1] CORRECT rotation, walk length and search depth counters";
+	}
+	else
+	{
+		std::cout << "[STATS CASE 1] INCORRECT counters\n";
+		stats.printStats();
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+#endif
+
+int testIntervalTree()
+{
+	IntervalTree<int> t;
+	std::vector<Interval<int>> intervals;
+	std::mt19937 generator(13);
+	std::uniform_int_distribution<int> startDistribution(0, 10000);
+	std::uniform_int_distribution<int> lengthDistribution(0, 100);
+	for (int i = 0; i < 2000; ++i)
+	{
+		const int lo = startDistribution(generator);
+		const int hi = lo + lengthDistribution(generator);
+		if (t.insertNode(lo, hi))
+		{
+			intervals.push_back({lo, hi});
+		}
+	}
+	// removing intervals rotates nodes, the max endpoints have to stay correct
+	for (size_t i = 0; i < intervals.size(); i += 3)
+	{
+		t.removeNode(intervals[i].lo, intervals[i].hi);
+		intervals[i] = Interval<int>{-1, -1};
+	}
+	intervals.erase(std::remove(intervals.begin(), intervals.end(), Interval<int>{-1, -1}), intervals.end());
+	std::sort(intervals.begin(), intervals.end());
+
+	bool allQueriesMatch = true;
+	for (int lo = 0; lo < 10200; lo += 97)
+	{
+		std::vector<Interval<int>> expected;
+		for (const auto &interval : intervals)
+		{
+			if (interval.overlaps(lo, lo + 50))
+				expected.push_back(interval);
+		}
+		allQueriesMatch = allQueriesMatch && t.findOverlapping(lo, lo + 50) == expected;
+	}
+
+	if (allQueriesMatch)
+	{
+		std::cout << "[INTERVAL CASE 1] CORRECT overlap queries after inserts and removes";
+	}
+	else
+	{
+		std::cout << "[INTERVAL CASE 1] INCORRECT overlap queries";
+	}
+	std::cout << "\n";
+
+	IntervalTree<int> tStabbing;
+	for (const auto &interval : std::vector<Interval<int>>{{1, 5}, {3, 8}, {6, 10}, {9, 9}, {12, 20}})
+	{
+		tStabbing.insertNode(interval.lo, interval.hi);
+	}
+	if (tStabbing.stabbingQuery(4) == std::vector<Interval<int>>{{1, 5}, {3, 8}} &&
+		tStabbing.stabbingQuery(9) == std::vector<Interval<int>>{{6, 10}, {9, 9}} &&
+		tStabbing.stabbingQuery(11).empty() &&
+		tStabbing.getRoot()->getMaxHi() == 20)
+	{
+		std::cout << "[INTERVAL CASE 2] CORRECT stabbing queries";
+	}
+	else
+	{
+		std::cout << "[INTERVAL CASE 2] INCORRECT stabbing queries";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testAVLTreeFingerSearch()
+{
+	// nearly sorted keys, every insertion starts at the node of the previous one
+	AVLTree<int> t;
+	std::set<int> expected;
+	std::mt19937 generator(17);
+	std::uniform_int_distribution<int> jitterDistribution(-10, 10);
+	AVLNode<int> *hint = nullptr;
+	bool allHintsMatch = true;
+	for (int i = 0; i < 10000; ++i)
+	{
+		const int key = i + jitterDistribution(generator);
+		hint = t.insertNode(hint, key);
+		expected.insert(key);
+		allHintsMatch = allHintsMatch && hint != nullptr && hint->getData() == key;
+	}
+
+	bool isValid = true;
+	std::vector<int> inorder;
+	checkAVLSubtree(t.getRoot(), static_cast<AVLNode<int> *>(nullptr), isValid, inorder);
+
+	if (allHintsMatch && isValid && inorder == std::vector<int>(expected.begin(), expected.end()))
+	{
+		std::cout << "[FINGER CASE 1] CORRECT insertion with hint keeps the tree balanced";
+	}
+	else
+	{
+		std::cout << "[FINGER CASE 1] INCORRECT insertion with hint";
+	}
+	std::cout << "\n";
+
+	// search forwards and backwards from a finger, including keys that do not exist
+	AVLNode<int> *finger = t.searchNode(*expected.lower_bound(5000));
+	bool allSearchesMatch = finger != nullptr;
+	for (int key = 4900; key < 5100 && allSearchesMatch; ++key)
+	{
+		AVLNode<int> *found = t.searchFrom(finger, key);
+		allSearchesMatch = expected.count(key) == 1 ? found != nullptr && found->getData() == key : found == nullptr;
+	}
+	if (allSearchesMatch &&
+		t.searchFrom(finger, -100) == nullptr &&
+		t.searchFrom(finger, 0) == t.searchNode(0))
+	{
+		std::cout << "[FINGER CASE 2] CORRECT finger search in both directions";
+	}
+	else
+	{
+		std::cout << "[FINGER CASE 2] INCORRECT finger search";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testTreeFile()
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "CDataStructure_tree_file_test.bin").string();
+
+	AVLTree<int> t;
+	for (int i = 0; i < 5000; ++i)
+	{
+		t.insertNode((i * 7919) % 10007);
+	}
+	{
+		std::ofstream out(path, std::ios::binary);
+		t.serialize(out);
+	}
+
+	AVLTree<int> tLoaded;
+	std::ifstream in(path, std::ios::binary);
+	const bool loaded = tLoaded.deserialize(in);
+	bool isValid = true;
+	std::vector<int> inorder;
+	std::vector<int> inorderLoaded;
+	checkAVLSubtree(t.getRoot(), static_cast<AVLNode<int> *>(nullptr), isValid, inorder);
+	checkAVLSubtree(tLoaded.getRoot(), static_cast<AVLNode<int> *>(nullptr), isValid, inorderLoaded);
+
+	MappedTree<int> mapped;
+	bool allMappedSearchesMatch = mapped.open(path) && mapped.getSize() == 5000;
+	for (int i = 0; i < 10007 && allMappedSearchesMatch; ++i)
+	{
+		const int *found = mapped.searchNode(i);
+		allMappedSearchesMatch = (t.searchNode(i) != nullptr) == (found != nullptr) && (found == nullptr || *found == i);
+	}
+
+	if (loaded &&
+		isValid &&
+		inorder == inorderLoaded &&
+		tLoaded.getRoot()->getData() == t.getRoot()->getData() &&
+		tLoaded.getRoot()->getBf() == t.getRoot()->getBf() &&
+		allMappedSearchesMatch)
+	{
+		std::cout << "[TREE FILE CASE 1] CORRECT AVL tree is reloaded and searched in place";
+	}
+	else
+	{
+		std::cout << "[TREE FILE CASE 1] INCORRECT AVL tree file";
+	}
+	std::cout << "\n";
+	mapped.close();
+
+	// a degenerated BST is written and read without recursion, and a file without balance factors is no AVL tree
+	BinarySearchTree<int> bst;
+	for (int i = 0; i < 10000; ++i)
+	{
+		bst.insertNode(i);
+	}
+	std::stringstream bstFile;
+	bst.serialize(bstFile);
+	const std::string bstBytes = bstFile.str();
+	BinarySearchTree<int> bstLoaded;
+	std::stringstream bstIn(bstBytes);
+	AVLTree<int> tFromBst;
+	std::stringstream avlIn(bstBytes);
+	std::stringstream truncatedIn(bstBytes.substr(0, bstBytes.size() / 2));
+
+	if (bstLoaded.deserialize(bstIn) &&
+		bstLoaded.find(0) != nullptr &&
+		!tFromBst.deserialize(avlIn) &&
+		!bstLoaded.deserialize(truncatedIn) &&
+		bstLoaded.find(9999) != nullptr)
+	{
+		std::cout << "[TREE FILE CASE 2] CORRECT BST file is reloaded, invalid files are rejected";
+	}
+	else
+	{
+		std::cout << "[TREE FILE CASE 2] INCORRECT BST file";
+	}
+	std::cout << "\n";
+
+	// files with a valid structure but unordered data or wrong balance factors are rejected as well
+	std::stringstream avlFile;
+	t.serialize(avlFile);
+	const std::string avlBytes = avlFile.str();
+	std::stringstream avlFileAgain;
+	t.serialize(avlFileAgain);
+	const auto recordOffset = [](const size_t record, const size_t member)
+	{ return sizeof(TreeFileHeader) + record * sizeof(TreeFileNode<int>) + member; };
+
+	// the root is larger than the whole left subtree
+	std::string unorderedBytes = avlBytes;
+	const int largest = 20000;
+	std::memcpy(&unorderedBytes[recordOffset(1, offsetof(TreeFileNode<int>, data))], &largest, sizeof(largest));
+	std::string unbalancedBytes = avlBytes;
+	unbalancedBytes[recordOffset(0, offsetof(TreeFileNode<int>, bf))] = 2;
+	// in range, but the last record in pre-order is a leaf, which has no subtrees that could differ in height
+	std::string wrongBfBytes = avlBytes;
+	wrongBfBytes[recordOffset(t.getSize() - 1, offsetof(TreeFileNode<int>, bf))] = 1;
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << unorderedBytes;
+	}
+
+	AVLTree<int> tRejected;
+	BinarySearchTree<int> bstRejected;
+	std::stringstream unorderedAvlIn(unorderedBytes);
+	std::stringstream unorderedBstIn(unorderedBytes);
+	std::stringstream unbalancedIn(unbalancedBytes);
+	std::stringstream wrongBfIn(wrongBfBytes);
+	std::stringstream validIn(avlBytes);
+	if (avlBytes == avlFileAgain.str() &&
+		!tRejected.deserialize(unorderedAvlIn) &&
+		!bstRejected.deserialize(unorderedBstIn) &&
+		!tRejected.deserialize(unbalancedIn) &&
+		!tRejected.deserialize(wrongBfIn) &&
+		!mapped.open(path) &&
+		tRejected.deserialize(validIn))
+	{
+		std::cout << "[TREE FILE CASE 3] CORRECT unordered or unbalanced files are rejected";
+	}
+	else
+	{
+		std::cout << "[TREE FILE CASE 3] INCORRECT unordered or unbalanced tree file";
+	}
+	std::cout << "\n";
+
+	std::filesystem::remove(path);
+	return 0;
+}
+
+int testAVLTreeLazyDeletion()
+{
+	AVLTree<int> t;
+	t.setCompactionThreshold(0.5);
+	for (int i = 0; i < 1000; ++i)
+	{
+		t.insertNode(i);
+	}
+	AVLNode<int> *_999 = t.searchNode(999);
+	const int rootBefore = t.getRoot()->getData();
+
+	// no rotations while marking nodes dead, dead nodes are not found and can be inserted again
+	for (int i = 0; i < 400; ++i)
+	{
+		t.removeNodeLazy(i);
+	}
+	t.insertNode(7);
+	if (t.getDeadCount() == 399 &&
+		t.getSize() == 601 &&
+		t.getRoot()->getData() == rootBefore &&
+		t.searchNode(6) == nullptr &&
+		t.searchNode(7) != nullptr &&
+		!t.removeNodeLazy(6) &&
+		!t.removeNode(6))
+	{
+		std::cout << "[LAZY DELETION CASE 1] CORRECT nodes are marked dead without rebalancing";
+	}
+	else
+	{
+		std::cout << "[LAZY DELETION CASE 1] INCORRECT marking nodes dead";
+	}
+	std::cout << "\n";
+
+	// crossing half of the nodes compacts the tree
+	for (int i = 400; i < 502; ++i)
+	{
+		t.removeNodeLazy(i);
+	}
+	bool isValid = true;
+	std::vector<int> inorder;
+	checkAVLSubtree(t.getRoot(), static_cast<AVLNode<int> *>(nullptr), isValid, inorder);
+	std::vector<int> expected = {7};
+	for (int i = 502; i < 1000; ++i)
+	{
+		expected.push_back(i);
+	}
+
+	if (t.getDeadCount() == 0 &&
+		isValid &&
+		inorder == expected &&
+		t.searchNode(999) == _999)
+	{
+		std::cout << "[LAZY DELETION CASE 2] CORRECT compaction rebuilds a balanced tree from the live nodes";
+	}
+	else
+	{
+		std::cout << "[LAZY DELETION CASE 2] INCORRECT compaction";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+// collects the data of a binary tree in-order and returns its height, works for every node with getLeft/getRight
+template<typename Node, typename T>
+int collectInorder(Node* node, std::vector<T>& inorder)
+{
+	if (node == nullptr)
+		return 0;
+	const int leftHeight = collectInorder(node->getLeft(), inorder);
+	inorder.push_back(node->getData());
+	const int rightHeight = collectInorder(node->getRight(), inorder);
+	return 1 + std::max(leftHeight, rightHeight);
+}
+
+int testBinarySearchTreeRebalancing()
+{
+	// sorted insertion degenerates the tree into a list, rebalance folds it into 14 full levels
+	BinarySearchTree<int> t;
+	for (int i = 0; i < 10000; ++i)
+	{
+		t.insertNode(i);
+	}
+	t.rebalance();
+	std::vector<int> inorder;
+	const int height = collectInorder(t.getRoot(), inorder);
+	if (height == 14 &&
+		inorder.size() == 10000 &&
+		std::is_sorted(inorder.begin(), inorder.end()) &&
+		t.find(9999) != nullptr)
+	{
+		std::cout << "[BST REBALANCE CASE 1] CORRECT rebalance builds a perfectly balanced tree";
+	}
+	else
+	{
+		std::cout << "[BST REBALANCE CASE 1] INCORRECT rebalance (height " << height << ")";
+	}
+	std::cout << "\n";
+
+	// in scapegoat mode, no node is deeper than log(n) / log(1 / 0.7) + 1 levels, also while removing
+	BinarySearchTree<int> tScapegoat;
+	tScapegoat.setScapegoatMode(true);
+	std::set<int> expected;
+	for (int i = 0; i < 100000; ++i)
+	{
+		tScapegoat.insertNode(i);
+		expected.insert(i);
+	}
+	const int sortedHeight = collectInorder(tScapegoat.getRoot(), inorder);
+	std::mt19937 generator(41);
+	std::uniform_int_distribution<int> distribution(0, 200000);
+	for (int i = 0; i < 100000; ++i)
+	{
+		const int key = distribution(generator);
+		if (i % 2 == 0)
+		{
+			tScapegoat.insertNode(key);
+			expected.insert(key);
+		}
+		else
+		{
+			tScapegoat.removeNode(key);
+			expected.erase(key);
+		}
+	}
+	inorder.clear();
+	const int mixedHeight = collectInorder(tScapegoat.getRoot(), inorder);
+	const int maxHeight = static_cast<int>(std::log(static_cast<double>(expected.size())) / -std::log(0.7)) + 1;
+	if (sortedHeight <= maxHeight &&
+		mixedHeight <= maxHeight &&
+		tScapegoat.getSize() == expected.size() &&
+		std::equal(inorder.begin(), inorder.end(), expected.begin(), expected.end()))
+	{
+		std::cout << "[BST REBALANCE CASE 2] CORRECT scapegoat mode keeps the height logarithmic (" << sortedHeight << ", " << mixedHeight << ")";
+	}
+	else
+	{
+		std::cout << "[BST REBALANCE CASE 2] INCORRECT scapegoat mode (height " << sortedHeight << ", " << mixedHeight << ")";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+// reference traversals for the visitor traversals, recursive like collectInorder
+template<typename Node, typename T>
+void collectPreorder(Node* node, std::vector<T>& preorder)
+{
+	if (node == nullptr)
+		return;
+	preorder.push_back(node->getData());
+	collectPreorder(node->getLeft(), preorder);
+	collectPreorder(node->getRight(), preorder);
+}
+
+template<typename Node, typename T>
+void collectPostorder(Node* node, std::vector<T>& postorder)
+{
+	if (node == nullptr)
+		return;
+	collectPostorder(node->getLeft(), postorder);
+	collectPostorder(node->getRight(), postorder);
+	postorder.push_back(node->getData());
+}
+
+int testTreeTraversals()
+{
+	std::mt19937 generator(43);
+	std::uniform_int_distribution<int> distribution(0, 50000);
+
+	// Morris traversals of the BST visit the same order as the recursive ones and leave no thread behind
+	BinarySearchTree<int> t;
+	for (int i = 0; i < 20000; ++i)
+	{
+		t.insertNode(distribution(generator));
+	}
+	std::vector<int> expectedInorder, expectedPreorder, expectedPostorder;
+	collectInorder(t.getRoot(), expectedInorder);
+	collectPreorder(t.getRoot(), expectedPreorder);
+	collectPostorder(t.getRoot(), expectedPostorder);
+	std::vector<int> inorder, preorder, postorder;
+	t.forEachInOrder([&inorder](const int& data) { inorder.push_back(data); });
+	t.forEachPreOrder([&preorder](const int& data) { preorder.push_back(data); });
+	t.forEachPostOrder([&postorder](const int& data) { postorder.push_back(data); });
+	std::vector<int> inorderAfter;
+	collectInorder(t.getRoot(), inorderAfter);
+	if (inorder == expectedInorder &&
+		preorder == expectedPreorder &&
+		postorder == expectedPostorder &&
+		inorderAfter == expectedInorder)
+	{
+		std::cout << "[TRAVERSAL CASE 1] CORRECT BST Morris traversals";
+	}
+	else
+	{
+		std::cout << "[TRAVERSAL CASE 1] INCORRECT BST Morris traversals";
+	}
+	std::cout << "\n";
+
+	// the AVL traversals follow the parent links and skip nodes removed lazily
+	AVLTree<int> avl;
+	std::set<int> expected;
+	for (int i = 0; i < 20000; ++i)
+	{
+		const int key = distribution(generator);
+		if (i % 3 == 2)
+		{
+			avl.removeNode(key);
+			expected.erase(key);
+		}
+		else
+		{
+			avl.insertNode(key);
+			expected.insert(key);
+		}
+	}
+	expectedPreorder.clear();
+	expectedPostorder.clear();
+	collectPreorder(avl.getRoot(), expectedPreorder);
+	collectPostorder(avl.getRoot(), expectedPostorder);
+	preorder.clear();
+	postorder.clear();
+	avl.forEachPreOrder([&preorder](const int& data) { preorder.push_back(data); });
+	avl.forEachPostOrder([&postorder](const int& data) { postorder.push_back(data); });
+	for (int i = 0; i < 100; ++i)
+	{
+		const int key = *expected.begin() + i;
+		avl.removeNodeLazy(key);
+		expected.erase(key);
+	}
+	inorder.clear();
+	avl.forEachInOrder([&inorder](const int& data) { inorder.push_back(data); });
+	if (preorder == expectedPreorder &&
+		postorder == expectedPostorder &&
+		std::equal(inorder.begin(), inorder.end(), expected.begin(), expected.end()))
+	{
+		std::cout << "[TRAVERSAL CASE 2] CORRECT AVLTree parent link traversals";
+	}
+	else
+	{
+		std::cout << "[TRAVERSAL CASE 2] INCORRECT AVLTree parent link traversals";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testAVLTreeParallelTraversal()
 {
+	AVLTree<int> t;
+	std::vector<int> keys(200000);
+	std::iota(keys.begin(), keys.end(), 0);
+	t.insertBatch(keys);
+	for (int i = 0; i < 1000; ++i)
+	{
+		t.removeNodeLazy(i * 7);
+	}
+
+	// the sum is commutative, the order check is not, both have to see every live node exactly once
+	const long long sum = t.parallelReduce(0LL, [](const int& data) { return static_cast<long long>(data); },
+		[](const long long lhs, const long long rhs) { return lhs + rhs; });
+	long long expectedSum = 0;
+	t.forEachInOrder([&expectedSum](const int& data) { expectedSum += data; });
+
+	struct SortedRange
+	{
+		int first;
+		int last;
+		bool sorted;
+		bool empty;
+	};
+	const SortedRange range = t.parallelReduce(SortedRange{0, 0, true, true},
+		[](const int& data) { return SortedRange{data, data, true, false}; },
+		[](const SortedRange& lhs, const SortedRange& rhs)
+		{
+			if (lhs.empty)
+				return rhs;
+			if (rhs.empty)
+				return lhs;
+			return SortedRange{lhs.first, rhs.last, lhs.sorted && rhs.sorted && lhs.last < rhs.first, false};
+		});
+	if (sum == expectedSum &&
+		range.sorted &&
+		range.first == 1 &&
+		range.last == 199999)
+	{
+		std::cout << "[PARALLEL AVL CASE 1] CORRECT parallelReduce combines in order";
+	}
+	else
+	{
+		std::cout << "[PARALLEL AVL CASE 1] INCORRECT parallelReduce (" << sum << ", expected " << expectedSum << ")";
+	}
+	std::cout << "\n";
+
+	std::atomic<long long> visitedSum(0);
+	std::atomic<size_t> visitedCount(0);
+	t.parallelForEach([&](const int& data)
+		{
+			visitedSum += data;
+			++visitedCount;
+		});
+	if (visitedSum == expectedSum && visitedCount == t.getSize())
+	{
+		std::cout << "[PARALLEL AVL CASE 2] CORRECT parallelForEach visits every live node once";
+	}
+	else
+	{
+		std::cout << "[PARALLEL AVL CASE 2] INCORRECT parallelForEach (" << visitedCount << " nodes)";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testDeferredTeardown()
+{
+	// a degenerate BST is freed without recursing, and every structure is empty and usable right after clearDeferred
+	BinarySearchTree<int> bst;
+	for (int i = 0; i < 5000; ++i)
+	{
+		bst.insertNode(i);
+	}
+	bst.clear();
+	const bool bstCleared = bst.getRoot() == nullptr && bst.getSize() == 0;
+	for (int i = 0; i < 5000; ++i)
+	{
+		bst.insertNode(i);
+	}
+	std::future<void> bstFreed = bst.clearDeferred();
+	bst.insertNode(42);
+
+	AVLTree<int> avl;
+	std::vector<int> keys(100000);
+	std::iota(keys.begin(), keys.end(), 0);
+	avl.insertBatch(keys);
+	std::future<void> avlFreed = avl.clearDeferred(true);
+	avl.insertNode(42);
+
+	LinkedList<int> list;
+	for (int i = 0; i < 5000; ++i)
+	{
+		list.insertAtHead(i);
+	}
+	std::future<void> listFreed = list.clearDeferred();
+	list.insertAtHead(42);
+
+	bstFreed.wait();
+	avlFreed.wait();
+	listFreed.wait();
+	if (bstCleared &&
+		bst.getSize() == 1 && bst.find(42) != nullptr && bst.find(43) == nullptr &&
+		avl.getSize() == 1 && avl.searchNode(42) != nullptr && avl.searchNode(43) == nullptr &&
+		list.getSize() == 1)
+	{
+		std::cout << "[TEARDOWN CASE 1] CORRECT clear and clearDeferred empty the structures";
+	}
+	else
+	{
+		std::cout << "[TEARDOWN CASE 1] INCORRECT clear and clearDeferred";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testTrace()
+{
+	// events of several threads end up in one trace, a full ring buffer keeps only the newest events
+	Trace::clear();
+	std::vector<std::thread> threads;
+	for (int id = 0; id < 3; ++id)
+	{
+		threads.emplace_back([id]()
+							 {
+			const size_t events = id == 0 ? Trace::BUFFER_CAPACITY + 100 : 10;
+			for (size_t i = 0; i < events; ++i)
+			{
+				TraceScope scope(id == 0 ? "testTrace \"wrapped\"" : "testTrace");
+			} });
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	std::stringstream trace;
+	const size_t written = Trace::writeChromeJson(trace);
+	const std::string json = trace.str();
+	Trace::clear();
+	std::stringstream cleared;
+	if (written == Trace::BUFFER_CAPACITY - 1 + 20 &&
+		json.find("{\"name\": \"testTrace \\\"wrapped\\\"\", \"ph\": \"X\"") != std::string::npos &&
+		json.rfind("]}") != std::string::npos &&
+		Trace::writeChromeJson(cleared) == 0)
+	{
+		std::cout << "[TRACE CASE 1] CORRECT trace events of all threads are written as Chrome JSON";
+	}
+	else
+	{
+		std::cout << "[TRACE CASE 1] INCORRECT trace events (" << written << " written)";
+	}
+	std::cout << "\n";
+
+	// threads that run one after the other reuse the buffer of the finished thread instead of registering a new one
+	for (int id = 0; id < 200; ++id)
+	{
+		std::thread([]()
+					{ TraceScope scope("testTrace reuse"); })
+			.join();
+	}
+	std::stringstream reused;
+	const size_t reusedWritten = Trace::writeChromeJson(reused);
+	std::set<std::string> threadIds;
+	const std::string reusedJson = reused.str();
+	for (size_t position = reusedJson.find("\"tid\": "); position != std::string::npos; position = reusedJson.find("\"tid\": ", position + 1))
+	{
+		threadIds.insert(reusedJson.substr(position, reusedJson.find(',', position) - position));
+	}
+	Trace::clear();
+	// a teardown thread of an earlier test may still be running and give its buffer back in between
+	if (reusedWritten >= 200 && threadIds.size() <= 2)
+	{
+		std::cout << "[TRACE CASE 2] CORRECT buffers of finished threads are reused";
+	}
+	else
+	{
+		std::cout << "[TRACE CASE 2] INCORRECT buffers of finished threads (" << threadIds.size() << " thread ids)";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testLatencyHistogram()
+{
+	// every value is recorded with 3 significant digits
+	LatencyHistogram h;
+	for (uint64_t value = 1; value <= 1000000; ++value)
+	{
+		h.recordValue(value);
+	}
+	const auto isClose = [](const double value, const double expected)
+	{ return std::abs(value - expected) <= expected * 0.001; };
+	if (h.getTotalCount() == 1000000 &&
+		h.getMin() == 1 && h.getMax() == 1000000 &&
+		isClose(static_cast<double>(h.getValueAtPercentile(50)), 500000) &&
+		isClose(static_cast<double>(h.getValueAtPercentile(99.9)), 999000) &&
+		h.getValueAtPercentile(100) == 1000000 &&
+		isClose(h.getMean(), 500000.5))
+	{
+		std::cout << "[LATENCY HISTOGRAM CASE 1] CORRECT percentiles within the precision";
+	}
+	else
+	{
+		std::cout << "[LATENCY HISTOGRAM CASE 1] INCORRECT percentiles (p50 " << h.getValueAtPercentile(50) << ", p99.9 " << h.getValueAtPercentile(99.9) << ")";
+	}
+	std::cout << "\n";
+
+	// histograms recorded per thread and merged equal one histogram of all values, also with a different precision
+	std::vector<LatencyHistogram> perThread(2);
+	std::vector<std::thread> threads;
+	for (int id = 0; id < 2; ++id)
+	{
+		threads.emplace_back([id, &perThread]()
+							 {
+			for (uint64_t value = 1 + id; value <= 1000000; value += 2)
+			{
+				perThread[id].recordValue(value * 1000);
+			} });
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	LatencyHistogram merged;
+	LatencyHistogram mergedLessPrecise(LatencyHistogram::DEFAULT_HIGHEST_TRACKABLE_VALUE, 2);
+	for (const LatencyHistogram &histogram : perThread)
+	{
+		merged.add(histogram);
+		mergedLessPrecise.add(histogram);
+	}
+	LatencyHistogram single;
+	for (uint64_t value = 1; value <= 1000000; ++value)
+	{
+		single.recordValue(value * 1000);
+	}
+	bool mergedMatches = merged.getTotalCount() == 1000000 && mergedLessPrecise.getTotalCount() == 1000000 &&
+						 merged.getMin() == single.getMin() && merged.getMax() == single.getMax();
+	for (const double percentile : {1.0, 50.0, 99.0, 99.99, 100.0})
+	{
+		mergedMatches = mergedMatches &&
+						merged.getValueAtPercentile(percentile) == single.getValueAtPercentile(percentile) &&
+						std::abs(static_cast<double>(mergedLessPrecise.getValueAtPercentile(percentile)) - static_cast<double>(merged.getValueAtPercentile(percentile))) <= static_cast<double>(merged.getValueAtPercentile(percentile)) * 0.01;
+	}
+
+	// a 100 us stall at a 10 us request interval hides 9 requests that waited 90, 80, ... 10 us
+	LatencyHistogram corrected;
+	corrected.recordCorrectedValue(100000, 10000);
+	if (mergedMatches &&
+		corrected.getTotalCount() == 10 &&
+		corrected.getMin() == 10000 &&
+		isClose(static_cast<double>(corrected.getValueAtPercentile(50)), 50000))
+	{
+		std::cout << "[LATENCY HISTOGRAM CASE 2] CORRECT merging and coordinated omission correction";
+	}
+	else
+	{
+		std::cout << "[LATENCY HISTOGRAM CASE 2] INCORRECT merging or coordinated omission correction (p50 " << corrected.getValueAtPercentile(50) << ")";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testMemoryUsage()
+{
+	// Constants
+	static constexpr int ELEMENTS = 1000;
+
+	LinkedList<int> ll;
+	BinarySearchTree<int> bst;
+	AVLTree<int> avl;
+	HashTable<int, int> ht(64);
+	for (int i = 0; i < ELEMENTS; ++i)
+	{
+		ll.insertAtHead(i % 10);
+		bst.insertNode(i);
+		avl.insertNode(i);
+		ht.put(i, i);
+	}
+	ll.deleteNodesGivenData(0);
+	avl.setCompactionThreshold(1.0);
+	for (int i = 0; i < ELEMENTS / 10; ++i)
+	{
+		avl.removeNodeLazy(i);
+	}
+
+	const MemoryUsage llUsage = ll.memoryUsage();
+	const MemoryUsage bstUsage = bst.memoryUsage();
+	const MemoryUsage avlUsage = avl.memoryUsage();
+	const MemoryUsage htUsage = ht.memoryUsage();
+	// every bin of the hash table is used
+	if (llUsage.peakBytes == 0 && bstUsage.peakBytes == 0 && avlUsage.peakBytes == 0 && htUsage.peakBytes == 0 &&
+		llUsage.elements == ELEMENTS - ELEMENTS / 10 && llUsage.allocations == llUsage.elements &&
+		llUsage.bytesLive == llUsage.elements * sizeof(Node<int>) &&
+		bstUsage.elements == ELEMENTS && bstUsage.bytesLive == ELEMENTS * sizeof(BinarySearchTreeNode<int>) &&
+		avlUsage.elements == ELEMENTS - ELEMENTS / 10 && avlUsage.allocations == ELEMENTS &&
+		avlUsage.getBytesPerElement() > static_cast<double>(sizeof(AVLNode<int>)) &&
+		htUsage.elements == ELEMENTS && htUsage.allocations == 1 + 64 + ELEMENTS &&
+		htUsage.bytesLive == 64 * sizeof(LinkedList<int> *) + 64 * sizeof(LinkedList<int>) + ELEMENTS * sizeof(Node<int>))
+	{
+		std::cout << "[MEMORY USAGE CASE 1] CORRECT memoryUsage of LinkedList, BinarySearchTree, AVLTree and HashTable";
+	}
+	else
+	{
+		std::cout << "[MEMORY USAGE CASE 1] INCORRECT memoryUsage of LinkedList, BinarySearchTree, AVLTree or HashTable";
+	}
+	std::cout << "\n";
+
+	// with tracking the heap grows by exactly what the containers report, without it nothing is counted
+	bool trackerMatches = false;
+	const MemoryUsage before = AllocationTracker::getUsage();
+	{
+		AllocationTracker::resetPeak();
+		HashTable<int, int> tracked(64);
+		for (int i = 0; i < ELEMENTS; ++i)
+		{
+			tracked.put(i, i);
+		}
+		const MemoryUsage after = AllocationTracker::getUsage();
+		if (AllocationTracker::isEnabled())
+		{
+			trackerMatches = after.bytesLive - before.bytesLive == tracked.memoryUsage().bytesLive &&
+							 after.allocations - before.allocations == tracked.memoryUsage().allocations &&
+							 after.peakBytes == after.bytesLive;
+		}
+		else
+		{
+			trackerMatches = after.bytesLive == 0 && after.peakBytes == 0 && AllocationTracker::getTotalAllocations() == 0;
+		}
+	}
+	if (trackerMatches && (!AllocationTracker::isEnabled() || AllocationTracker::getUsage().bytesLive == before.bytesLive))
+	{
+		std::cout << "[MEMORY USAGE CASE 2] CORRECT AllocationTracker " << (AllocationTracker::isEnabled() ? "counts the allocations of the container" : "is compiled out");
+	}
+	else
+	{
+		std::cout << "[MEMORY USAGE CASE 2] INCORRECT AllocationTracker";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testSplayTree()
+{
+	BinarySearchTree<int> bst;
+	SplayTree<int> t;
+	std::set<int> expected;
+	std::mt19937 generator(23);
+	std::uniform_int_distribution<int> distribution(0, 2000);
+	bool allOperationsMatch = true;
+	for (int i = 0; i < 20000; ++i)
+	{
+		const int key = distribution(generator);
+		switch (i % 3)
+		{
+		case 0:
+			allOperationsMatch = allOperationsMatch && t.insertNode(key) == expected.insert(key).second;
+			bst.insertNode(key);
+			break;
+		case 1:
+			allOperationsMatch = allOperationsMatch && t.removeNode(key) == (expected.erase(key) == 1);
+			break;
+		default:
+			allOperationsMatch = allOperationsMatch && (t.find(key) != nullptr) == (expected.count(key) == 1);
+			allOperationsMatch = allOperationsMatch && (bst.find(key) != nullptr) == (bst.DFS(key) != nullptr);
+			break;
+		}
+	}
+
+	if (allOperationsMatch)
+	{
+		std::cout << "[SPLAY CASE 1] CORRECT ordered find and splay tree operations";
+	}
+	else
+	{
+		std::cout << "[SPLAY CASE 1] INCORRECT ordered find or splay tree operations";
+	}
+	std::cout << "\n";
+
+	// sorted inserts make a path, accessing the deepest key roughly halves the depth of the path
+	SplayTree<int> tSorted;
+	for (int i = 0; i < 100000; ++i)
+	{
+		tSorted.insertNode(i);
+	}
+	BinarySearchTreeNode<int> *_0 = tSorted.find(0);
+	BinarySearchTreeNode<int> *_1 = tSorted.find(1);
+	if (_0 != nullptr &&
+		_1 == tSorted.getRoot() &&
+		_1->getLeft() == _0 &&
+		tSorted.find(100000) == nullptr)
+	{
+		std::cout << "[SPLAY CASE 2] CORRECT accessed keys are moved to the root";
+	}
+	else
+	{
+		std::cout << "[SPLAY CASE 2] INCORRECT splaying to the root";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testTreap()
+{
+	// sorted input would turn a BinarySearchTree into a list of 100000 nodes
+	Treap<int> t(7);
+	for (int i = 0; i < 100000; ++i)
+	{
+		t.insertNode(i);
+	}
+	std::vector<int> inorder;
+	const int height = collectInorder(t.getRoot(), inorder);
+	if (height < 60 &&
+		inorder.size() == 100000 &&
+		std::is_sorted(inorder.begin(), inorder.end()) &&
+		t.find(4242) != nullptr &&
+		!t.insertNode(4242) &&
+		t.removeNode(4242) &&
+		t.find(4242) == nullptr)
+	{
+		std::cout << "[TREAP CASE 1] CORRECT sorted insertion stays shallow (height " << height << ")";
+	}
+	else
+	{
+		std::cout << "[TREAP CASE 1] INCORRECT treap after sorted insertion (height " << height << ")";
+	}
+	std::cout << "\n";
+
+	// split into [0, 25000) and [25000, 100000) without 4242, then rejoin
+	Treap<int> greater(8);
+	t.split(25000, greater);
+	std::vector<int> smallerInorder;
+	std::vector<int> greaterInorder;
+	collectInorder(t.getRoot(), smallerInorder);
+	collectInorder(greater.getRoot(), greaterInorder);
+	const bool splitCorrect = smallerInorder.size() == 24999 &&
+		smallerInorder.back() == 24999 &&
+		greaterInorder.size() == 75000 &&
+		greaterInorder.front() == 25000;
+	t.merge(greater);
+	std::vector<int> mergedInorder;
+	collectInorder(t.getRoot(), mergedInorder);
+	inorder.erase(std::find(inorder.begin(), inorder.end(), 4242));
+	if (splitCorrect &&
+		greater.getRoot() == nullptr &&
+		mergedInorder == inorder)
+	{
+		std::cout << "[TREAP CASE 2] CORRECT split and merge";
+	}
+	else
+	{
+		std::cout << "[TREAP CASE 2] INCORRECT split or merge";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testRedBlackTree()
+{
+	RedBlackTree<int> t;
+	std::set<int> expected;
+	std::mt19937 generator(31);
+	std::uniform_int_distribution<int> distribution(0, 5000);
+	bool allOperationsMatch = true;
+	for (int i = 0; i < 50000; ++i)
+	{
+		const int key = distribution(generator);
+		if (i % 2 == 0)
+		{
+			t.insertNode(key);
+			expected.insert(key);
+		}
+		else
+		{
+			allOperationsMatch = allOperationsMatch && t.removeNode(key) == (expected.erase(key) == 1);
+		}
+		allOperationsMatch = allOperationsMatch && (t.searchNode(key) != nullptr) == (expected.count(key) == 1);
+	}
+
+	if (allOperationsMatch &&
+		t.getSize() == expected.size() &&
+		std::equal(t.begin(), t.end(), expected.begin(), expected.end()))
+	{
+		std::cout << "[RED BLACK CASE 1] CORRECT insertion, removal and in-order iteration";
+	}
+	else
+	{
+		std::cout << "[RED BLACK CASE 1] INCORRECT red-black tree operations";
+	}
+	std::cout << "\n";
+
+	// the root is black, no red node has a red child and all paths have the same amount of black nodes
+	std::function<int(RedBlackTreeNode<int> *)> blackHeight = [&](RedBlackTreeNode<int> *node) -> int
+	{
+		if (node == nullptr)
+			return 1;
+		if (node->isRed() &&
+			((node->hasLeft() && node->getLeft()->isRed()) || (node->hasRight() && node->getRight()->isRed())))
+			return -1;
+		const int leftHeight = blackHeight(node->getLeft());
+		const int rightHeight = blackHeight(node->getRight());
+		if (leftHeight < 0 || leftHeight != rightHeight)
+			return -1;
+		return leftHeight + (node->isRed() ? 0 : 1);
+	};
+	RedBlackTree<int> tSorted;
+	for (int i = 0; i < 100000; ++i)
+	{
+		tSorted.insertNode(i);
+	}
+	for (int i = 0; i < 100000; i += 3)
+	{
+		tSorted.removeNode(i);
+	}
+	if (!t.getRoot()->isRed() &&
+		blackHeight(t.getRoot()) > 0 &&
+		!tSorted.getRoot()->isRed() &&
+		blackHeight(tSorted.getRoot()) > 0 &&
+		tSorted.getSize() == 66666)
+	{
+		std::cout << "[RED BLACK CASE 2] CORRECT red-black properties hold";
+	}
+	else
+	{
+		std::cout << "[RED BLACK CASE 2] INCORRECT red-black properties are violated";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testConcurrentBST()
+{
+	static constexpr int THREADS = 4;
+	static constexpr int KEYS_PER_THREAD = 2000;
+	static constexpr int OPERATIONS = 50000;
+
+	ConcurrentBST<int> t;
+
+	// every thread works on its own interleaved keys, so its results have to match a sequential set
+	{
+		std::atomic<bool> allOperationsMatch(true);
+		std::vector<std::set<int>> expected(THREADS);
+		std::vector<std::thread> threads;
+		for (int id = 0; id < THREADS; ++id)
+		{
+			threads.emplace_back([&, id]()
+								 {
+				std::mt19937 generator(id);
+				std::uniform_int_distribution<int> keyDistribution(0, KEYS_PER_THREAD - 1);
+				for (int i = 0; i < OPERATIONS; ++i)
+				{
+					const int key = keyDistribution(generator) * THREADS + id;
+					bool matches = true;
+					switch (i % 3)
+					{
+					case 0:
+						matches = t.insertNode(key) == expected[id].insert(key).second;
+						break;
+					case 1:
+						matches = t.removeNode(key) == (expected[id].erase(key) == 1);
+						break;
+					default:
+						matches = t.containsNode(key) == (expected[id].count(key) == 1);
+						break;
+					}
+					if (!matches)
+					{
+						allOperationsMatch = false;
+					}
+				} });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		for (int key = 0; key < THREADS * KEYS_PER_THREAD; ++key)
+		{
+			if (t.containsNode(key) != (expected[key % THREADS].count(key) == 1))
+			{
+				allOperationsMatch = false;
+			}
+		}
+		if (allOperationsMatch)
+		{
+			std::cout << "[CONCURRENT BST CASE 1] CORRECT concurrent operations on disjoint keys";
+		}
+		else
+		{
+			std::cout << "[CONCURRENT BST CASE 1] INCORRECT concurrent operations on disjoint keys";
+		}
+		std::cout << "\n";
+	}
+
+	// all threads fight over a few keys, every successful insert adds one key and every successful removal takes one
+	{
+		static constexpr int CONTENDED_KEYS = 16;
+		std::atomic<int> expectedSize(0);
+		std::vector<std::thread> threads;
+		for (int id = 0; id < THREADS; ++id)
+		{
+			threads.emplace_back([&, id]()
+								 {
+				std::mt19937 generator(100 + id);
+				std::uniform_int_distribution<int> keyDistribution(1, CONTENDED_KEYS);
+				for (int i = 0; i < OPERATIONS; ++i)
+				{
+					const int key = -keyDistribution(generator);
+					if (i % 2 == 0)
+					{
+						expectedSize += t.insertNode(key) ? 1 : 0;
+					}
+					else
+					{
+						expectedSize -= t.removeNode(key) ? 1 : 0;
+					}
+				} });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		int size = 0;
+		for (int key = -CONTENDED_KEYS; key < 0; ++key)
+		{
+			size += t.containsNode(key) ? 1 : 0;
+		}
+		if (size == expectedSize)
+		{
+			std::cout << "[CONCURRENT BST CASE 2] CORRECT contended inserts and removals are linearizable";
+		}
+		else
+		{
+			std::cout << "[CONCURRENT BST CASE 2] INCORRECT contended inserts and removals (" << size << " keys, expected " << expectedSize << ")";
+		}
+		std::cout << "\n";
+	}
+
+	return 0;
+}
+
+int testConcurrentAVLTree()
+{
+	static constexpr int THREADS = 4;
+	static constexpr int KEYS_PER_THREAD = 5000;
+
+	ConcurrentAVLTree<int> t;
+
+	// every thread inserts its own interleaved range of keys
+	{
+		std::vector<std::thread> threads;
+		for (int id = 0; id < THREADS; ++id)
+		{
+			threads.emplace_back([&t, id]()
+								 {
+				for (int i = 0; i < KEYS_PER_THREAD; ++i)
+				{
+					t.insertNode(i * THREADS + id);
+				} });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	bool allInserted = true;
+	for (int i = 0; i < THREADS * KEYS_PER_THREAD; ++i)
+	{
+		allInserted = allInserted && t.containsNode(i);
+	}
+	if (allInserted && !t.insertNode(0))
+	{
+		std::cout << "[CONCURRENT CASE 1] CORRECT all keys inserted concurrently are found";
+	}
+	else
+	{
+		std::cout << "[CONCURRENT CASE 1] INCORRECT keys inserted concurrently are missing";
+	}
+	std::cout << "\n";
+
+	// remove all even keys while other threads keep searching the odd keys
+	{
+		std::atomic<bool> oddKeysAlwaysFound(true);
+		std::vector<std::thread> threads;
+		for (int id = 0; id < THREADS; ++id)
+		{
+			threads.emplace_back([&t, &oddKeysAlwaysFound, id]()
+								 {
+				for (int i = id * 2; i < THREADS * KEYS_PER_THREAD; i += THREADS * 2)
+				{
+					t.removeNode(i);
+					if (!t.containsNode(i + 1))
+					{
+						oddKeysAlwaysFound = false;
+					}
+				} });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		bool onlyOddKeys = true;
+		for (int i = 0; i < THREADS * KEYS_PER_THREAD; ++i)
+		{
+			onlyOddKeys = onlyOddKeys && (t.containsNode(i) == (i % 2 == 1));
+		}
+
+		// an AVL tree with n nodes never exceeds a height of about 1.44 * log2(n)
+		if (oddKeysAlwaysFound && onlyOddKeys && t.getHeight() <= 21)
+		{
+			std::cout << "[CONCURRENT CASE 2] CORRECT concurrent removal kept the tree consistent and balanced";
+		}
+		else
+		{
+			std::cout << "[CONCURRENT CASE 2] INCORRECT concurrent removal broke the tree";
+		}
+		std::cout << "\n";
+	}
+
+	return 0;
+}
+
+int testPersistentAVLTreeSnapshots()
+{
+	PersistentAVLTree<int> t;
+	for (int i = 1; i <= 100; ++i)
+	{
+		t.insertNode(i);
+	}
+
+	const auto snapshot = t.snapshot();
+	for (int i = 2; i <= 100; i += 2)
+	{
+		t.removeNode(i);
+	}
+
+	bool snapshotUnchanged = true;
+	bool onlyOddLeft = true;
+	for (int i = 1; i <= 100; ++i)
+	{
+		snapshotUnchanged = snapshotUnchanged && snapshot.searchNode(i) != nullptr;
+		onlyOddLeft = onlyOddLeft && ((t.searchNode(i) != nullptr) == (i % 2 == 1));
+	}
+	if (snapshotUnchanged && onlyOddLeft)
+	{
+		std::cout << "[PERSISTENT CASE 1] CORRECT snapshot keeps removed nodes";
+	}
+	else
+	{
+		std::cout << "[PERSISTENT CASE 1] INCORRECT snapshot is affected by later removals";
+	}
+	std::cout << "\n";
+
+	// inserting into the right subtree copies only the path, the left subtree is shared between both versions
+	PersistentAVLTree<int> small;
+	for (int i : {50, 30, 70, 20, 40, 60, 80})
+	{
+		small.insertNode(i);
+	}
+	const auto before = small.snapshot();
+	small.insertNode(90);
+	if (before.getRoot() != small.getRoot() &&
+		before.getRoot()->getLeft() == small.getRoot()->getLeft() &&
+		before.getRoot()->getRight()->getLeft() == small.getRoot()->getRight()->getLeft() &&
+		before.searchNode(90) == nullptr &&
+		small.searchNode(90) != nullptr)
+	{
+		std::cout << "[PERSISTENT CASE 2] CORRECT only the search path is copied";
+	}
+	else
+	{
+		std::cout << "[PERSISTENT CASE 2] INCORRECT untouched subtrees are not shared";
+	}
+	std::cout << "\n";
+
+	// ascending insertions need rotations, the new version must still be balanced
+	const auto root = t.getRoot();
+	if (root->getHeight() <= 7 && root->getBf() >= -1 && root->getBf() <= 1)
+	{
+		std::cout << "[PERSISTENT CASE 3] CORRECT tree stays balanced";
+	}
+	else
+	{
+		std::cout << "[PERSISTENT CASE 3] INCORRECT tree is unbalanced";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+// counts how often a value is copied, the AVLMap should never copy
+struct CopyCounter
+{
+	explicit CopyCounter(int value) : value(value) {}
+	CopyCounter(const CopyCounter &other) : value(other.value) { ++copies; }
+	CopyCounter(CopyCounter &&other) noexcept : value(other.value) {}
+	CopyCounter &operator=(const CopyCounter &other)
+	{
+		value = other.value;
+		++copies;
+		return *this;
+	}
+	CopyCounter &operator=(CopyCounter &&other) noexcept
+	{
+		value = other.value;
+		return *this;
+	}
+
+	int value;
+	static inline int copies = 0;
+};
+
+int testAVLMap()
+{
+	{
+		AVLMap<int, CopyCounter> m;
+		for (int i = 0; i < 100; ++i)
+		{
+			m.try_emplace(i, i);
+		}
+		const auto nodeBefore = m.searchNode(42);
+		const auto assigned = m.insert_or_assign(42, CopyCounter(4242));
+		const auto emplaced = m.try_emplace(42, 0);
+		if (CopyCounter::copies == 0 &&
+			!assigned.second &&
+			!emplaced.second &&
+			assigned.first == nodeBefore &&
+			m.searchNode(42)->getValue().value == 4242)
+		{
+			std::cout << "[AVL MAP CASE 1] CORRECT values are updated in place without copies";
+		}
+		else
+		{
+			std::cout << "[AVL MAP CASE 1] INCORRECT values are copied or not updated";
+		}
+		std::cout << "\n";
+	}
+
+	{
+		AVLMap<std::string, std::unique_ptr<int>> m;
+		m.try_emplace("b", std::make_unique<int>(2));
+		m.insert_or_assign("a", std::make_unique<int>(1));
+		m.insert_or_assign("a", std::make_unique<int>(10));
+		m["c"] = std::make_unique<int>(3);
+		const bool removedB = m.removeNode("b");
+		const bool removedMissing = m.removeNode("x");
+		if (*m["a"] == 10 &&
+			*m["c"] == 3 &&
+			removedB &&
+			!removedMissing &&
+			m.searchNode("b") == nullptr)
+		{
+			std::cout << "[AVL MAP CASE 2] CORRECT move-only values";
+		}
+		else
+		{
+			std::cout << "[AVL MAP CASE 2] INCORRECT move-only values";
+		}
+		std::cout << "\n";
+	}
+
+	{
+		AVLMap<int, int> m;
+		for (int i = 0; i < 1000; ++i)
+		{
+			++m[i % 10];
+		}
+		bool allCounted = true;
+		for (int i = 0; i < 10; ++i)
+		{
+			allCounted = allCounted && m[i] == 100;
+		}
+		if (allCounted)
+		{
+			std::cout << "[AVL MAP CASE 3] CORRECT operator[] inserts default values and updates in place";
+		}
+		else
+		{
+			std::cout << "[AVL MAP CASE 3] INCORRECT operator[]";
+		}
+		std::cout << "\n";
+	}
+
+	return 0;
+}
+
+int testCompactAVLTree()
+{
+	if (sizeof(CompactAVLNode<int>) < sizeof(AVLNode<int>) &&
+		sizeof(CompactAVLNode<int, true>) < sizeof(AVLNode<int>))
+	{
+		std::cout << "[COMPACT CASE 1] CORRECT compact nodes are smaller: " << sizeof(CompactAVLNode<int>) << " (no parent), "
+				  << sizeof(CompactAVLNode<int, true>) << " (parent) vs " << sizeof(AVLNode<int>) << " bytes";
+	}
+	else
+	{
+		std::cout << "[COMPACT CASE 1] INCORRECT compact nodes are not smaller";
+	}
+	std::cout << "\n";
+
+	// same sequence as [INSERTION CASE 5], with and without parent pointers
+	CompactAVLTree<int> t;
+	AVLTree<int, CompactAVLNode<int, true>> tWithParent;
+	for (int i : {50, 60, 70, 40, 30, 80, 75, 20, 25, 15})
+	{
+		t.insertNode(i);
+		tWithParent.insertNode(i);
+	}
+
+	const auto _25 = t.searchNode(25);
+	const auto _20 = t.searchNode(20);
+	const auto _25WithParent = tWithParent.searchNode(25);
+	if (t.getRoot()->getData() == 60 &&
+		t.getRoot()->getBf() == -1 &&
+		_25->getBf() == 0 &&
+		_20->getBf() == -1 &&
+		_25->getLeft() == _20 &&
+		_25->getRight() == t.searchNode(40) &&
+		tWithParent.getRoot()->getData() == 60 &&
+		_25WithParent->getParent() == tWithParent.getRoot() &&
+		_25WithParent->getBf() == 0)
+	{
+		std::cout << "[COMPACT CASE 2] CORRECT rotations keep balance factors in the tag bits";
+	}
+	else
+	{
+		std::cout << "[COMPACT CASE 2] INCORRECT rotations with compact nodes";
+	}
+	std::cout << "\n";
+
+	// same sequence as [DELETION EDGE CASE]
+	CompactAVLTree<int> tDeletion;
+	for (int i : {50, 30, 60, 20, 35, 55, 70, 15, 52, 58, 77, 57})
+	{
+		tDeletion.insertNode(i);
+	}
+	tDeletion.removeNode(35);
+	const auto newRoot = tDeletion.getRoot();
+	if (newRoot->getData() == 55 &&
+		newRoot->getBf() == 0 &&
+		tDeletion.searchNode(50)->getBf() == -1 &&
+		tDeletion.searchNode(58)->getBf() == -1 &&
+		tDeletion.searchNode(70)->getBf() == 1 &&
+		tDeletion.searchNode(35) == nullptr)
+	{
+		std::cout << "[COMPACT CASE 3] CORRECT deletion along the search-path stack";
+	}
+	else
+	{
+		std::cout << "[COMPACT CASE 3] INCORRECT deletion along the search-path stack";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testFrozenAVLTree()
+{
+	AVLTree<int> t;
+	std::vector<int> sorted;
+	for (int i = 0; i < 3000; i += 3)
+	{
+		t.insertNode(i);
+		sorted.push_back(i);
+	}
+
+	const auto frozen = t.freeze();
+	bool allLowerBoundsMatch = frozen.getSize() == sorted.size();
+	for (int key = -5; key < 3005; ++key)
+	{
+		const auto expected = std::lower_bound(sorted.begin(), sorted.end(), key);
+		const int *found = frozen.lower_bound(key);
+		if (expected == sorted.end())
+		{
+			allLowerBoundsMatch = allLowerBoundsMatch && found == nullptr;
+		}
+		else
+		{
+			allLowerBoundsMatch = allLowerBoundsMatch && found != nullptr && *found == *expected;
+		}
+	}
+
+	if (allLowerBoundsMatch &&
+		frozen.searchNode(999) != nullptr &&
+		frozen.searchNode(1000) == nullptr &&
+		t.searchNode(999) != nullptr)
+	{
+		std::cout << "[FROZEN CASE 1] CORRECT lower_bound of the frozen layout";
+	}
+	else
+	{
+		std::cout << "[FROZEN CASE 1] INCORRECT lower_bound of the frozen layout";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+int testBPlusTree()
+{
+	// small nodes so that a few thousand keys already need splits, borrows and merges on several levels
+	BPlusTree<int, int, 8> t;
+	std::map<int, int> expected;
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<int> keyDistribution(0, 2000);
+	bool allOperationsMatch = true;
+	for (int i = 0; i < 20000; ++i)
+	{
+		const int key = keyDistribution(generator);
+		if (i % 3 == 2)
+		{
+			allOperationsMatch = allOperationsMatch && t.removeNode(key) == (expected.erase(key) == 1);
+		}
+		else
+		{
+			allOperationsMatch = allOperationsMatch && t.insertNode(key, i) == expected.emplace(key, i).second;
+		}
+	}
+	for (int key = 0; key <= 2000; ++key)
+	{
+		const auto it = expected.find(key);
+		const int *found = t.searchNode(key);
+		allOperationsMatch = allOperationsMatch && (it == expected.end() ? found == nullptr : found != nullptr && *found == it->second);
+	}
+
+	if (allOperationsMatch && t.getSize() == expected.size())
+	{
+		std::cout << "[BPLUS CASE 1] CORRECT random inserts and removes";
+	}
+	else
+	{
+		std::cout << "[BPLUS CASE 1] INCORRECT random inserts and removes";
+	}
+	std::cout << "\n";
+
+	std::vector<int> scanned;
+	t.rangeScan(500, 1500, [&](const int &key, int &)
+				{ scanned.push_back(key); });
+	std::vector<int> expectedScan;
+	for (auto it = expected.lower_bound(500); it != expected.end() && it->first <= 1500; ++it)
+	{
+		expectedScan.push_back(it->first);
+	}
+
+	BPlusTree<long long, int> tWide;
+	for (long long i = 0; i < 100000; ++i)
+	{
+		tWide.insertNode(i * 3, static_cast<int>(i));
+	}
+	if (scanned == expectedScan &&
+		tWide.getHeight() == 4 &&
+		tWide.searchNode(299997) != nullptr &&
+		tWide.searchNode(300000) == nullptr &&
+		*tWide.searchNode(300) == 100)
+	{
+		std::cout << "[BPLUS CASE 2] CORRECT range scan over linked leaves";
+	}
+	else
+	{
+		std::cout << "[BPLUS CASE 2] INCORRECT range scan over linked leaves";
+	}
+	std::cout << "\n";
+
+	return 0;
+}
+
+// throughput of containsNode/insertNode/removeNode mixes for every thread count, Tree is a concurrent set
+template <typename Tree>
+int benchmarkConcurrentTree(const char *treeName)
+{
+	// Constants
+	static constexpr int KEY_RANGE = 200000;
+	static constexpr auto RUN_DURATION = std::chrono::milliseconds(500);
+	static const std::vector<int> THREAD_COUNTS = {1, 2, 4, 8, 16, 32, 64};
+
+	struct Mix
+	{
+		const char *name;
+		int containsPercentage;
+		int insertPercentage; // the remaining percentage are removals
+	};
+	static const std::vector<Mix> MIXES = {{"read-mostly (90/5/5)", 90, 5}, {"write-heavy (50/25/25)", 50, 25}};
+
+	for (const auto &mix : MIXES)
+	{
+		std::cout << treeName << " " << mix.name << "\n";
+		std::cout << "threads\tMops/s\n";
+
+		for (const auto threadCount : THREAD_COUNTS)
+		{
+			Tree t;
+
+			// prefill half of the key range so that inserts and removes succeed about half of the time
+			std::mt19937 generator(42);
+			std::uniform_int_distribution<int> keyDistribution(0, KEY_RANGE - 1);
+			for (int i = 0; i < KEY_RANGE / 2; ++i)
+			{
+				t.insertNode(keyDistribution(generator));
+			}
+
+			std::atomic<bool> start(false);
+			std::atomic<bool> stop(false);
+			std::atomic<size_t> totalOperations(0);
+			std::vector<std::thread> threads;
+
+			for (int id = 0; id < threadCount; ++id)
+			{
+				threads.emplace_back([&, id]()
+									 {
+					std::mt19937 threadGenerator(id);
+					std::uniform_int_distribution<int> threadKeyDistribution(0, KEY_RANGE - 1);
+					std::uniform_int_distribution<int> operationDistribution(0, 99);
+					size_t operations = 0;
+
+					while (!start.load())
+					{
+						std::this_thread::yield();
+					}
+
+					while (!stop.load(std::memory_order_relaxed))
+					{
+						const int key = threadKeyDistribution(threadGenerator);
+						const int operation = operationDistribution(threadGenerator);
+						if (operation < mix.containsPercentage)
+						{
+							t.containsNode(key);
+						}
+						else if (operation < mix.containsPercentage + mix.insertPercentage)
+						{
+							t.insertNode(key);
+						}
+						else
+						{
+							t.removeNode(key);
+						}
+						++operations;
+					}
+					totalOperations += operations; });
+			}
+
+			const auto begin = std::chrono::steady_clock::now();
+			start = true;
+			std::this_thread::sleep_for(RUN_DURATION);
+			stop = true;
+			for (auto &thread : threads)
+			{
+				thread.join();
+			}
+			const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - begin;
+
+			std::cout << threadCount << "\t" << totalOperations.load() / elapsed.count() << "\n";
+		}
+		std::cout << "\n";
+	}
+
+	return 0;
+}
+
+int benchmarkConcurrentAVLTree()
+{
+	return benchmarkConcurrentTree<ConcurrentAVLTree<int>>("ConcurrentAVLTree");
+}
+
+int benchmarkConcurrentBST()
+{
+	return benchmarkConcurrentTree<ConcurrentBST<int>>("ConcurrentBST");
+}
+
+int benchmarkAVLTreeParallelReduce()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 5000000;
+	static constexpr int RUNS = 10;
+
+	AVLTree<int> t;
+	std::vector<int> keys(TREE_SIZE);
+	std::iota(keys.begin(), keys.end(), 0);
+	t.insertBatch(keys);
+
+	const auto map = [](const int& data) { return static_cast<long long>(data) * data % 1000003; };
+	const auto reduce = [](const long long lhs, const long long rhs) { return lhs + rhs; };
+
+	long long sequentialSum = 0;
+	std::cout << "AVLTree::forEachInOrder " << RUNS << " sums of " << TREE_SIZE << " ";
+	{
+		Timer timer;
+		for (int run = 0; run < RUNS; ++run)
+		{
+			t.forEachInOrder([&](const int& data) { sequentialSum = reduce(sequentialSum, map(data)); });
+		}
+	}
+	long long parallelSum = 0;
+	std::cout << "AVLTree::parallelReduce on " << std::thread::hardware_concurrency() << " hardware threads ";
+	{
+		Timer timer;
+		for (int run = 0; run < RUNS; ++run)
+		{
+			parallelSum += t.parallelReduce(0LL, map, reduce);
+		}
+	}
+	if (parallelSum != sequentialSum)
+	{
+		std::cout << "parallelReduce differs from forEachInOrder\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+int benchmarkDeferredTeardown()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 5000000;
+
+	std::vector<int> keys(TREE_SIZE);
+	std::iota(keys.begin(), keys.end(), 0);
+
+	std::cout << "AVLTree::clear of " << TREE_SIZE << " nodes ";
+	{
+		AVLTree<int> t;
+		t.insertBatch(keys);
+		Timer timer;
+		t.clear();
+	}
+	for (const bool parallel : {false, true})
+	{
+		AVLTree<int> t;
+		t.insertBatch(keys);
+		std::future<void> freed;
+		std::cout << "AVLTree::clearDeferred(" << (parallel ? "parallel" : "sequential") << ") returns after ";
+		{
+			Timer timer;
+			freed = t.clearDeferred(parallel);
+		}
+		std::cout << "AVLTree::clearDeferred(" << (parallel ? "parallel" : "sequential") << ") frees after ";
+		{
+			Timer timer;
+			freed.wait();
+		}
+	}
+
+	std::cout << "LinkedList::clear of " << TREE_SIZE << " nodes ";
+	{
+		LinkedList<int> list;
+		for (const int key : keys)
+		{
+			list.insertAtHead(key);
+		}
+		Timer timer;
+		list.clear();
+	}
+	{
+		LinkedList<int> list;
+		for (const int key : keys)
+		{
+			list.insertAtHead(key);
+		}
+		std::future<void> freed;
+		std::cout << "LinkedList::clearDeferred returns after ";
+		{
+			Timer timer;
+			freed = list.clearDeferred();
+		}
+		freed.wait();
+	}
+
+	return 0;
+}
+
+// runs the instrumented operations of the data structures on several threads and writes their trace to path,
+// build with -DENABLE_TRACE=ON and open the file in chrome://tracing or ui.perfetto.dev
+int traceDataStructures(const std::string &path)
+{
+	// Constants
+	static constexpr int THREADS = 4;
+	static constexpr int KEYS = 200000;
+
+	Trace::clear();
+	std::vector<std::thread> threads;
+	for (int id = 0; id < THREADS; ++id)
+	{
+		threads.emplace_back([id]()
+							 {
+			std::mt19937 generator(id);
+			std::uniform_int_distribution<int> distribution(0, KEYS * 4);
+			std::vector<int> keys;
+			for (int i = 0; i < KEYS; ++i)
+			{
+				keys.push_back(distribution(generator));
+			}
+
+			RedBlackTree<int> rbt;
+			BPlusTree<int, int> bpt;
+			BinarySearchTree<int> bst;
+			for (const int key : keys)
+			{
+				rbt.insertNode(key);
+				bpt.insertNode(key, key);
+				bst.insertNode(key);
+			}
+			bst.rebalance();
+
+			AVLTree<int> avl;
+			avl.insertBatch(keys, true);
+			for (int i = 0; i < KEYS / 10; ++i)
+			{
+				avl.insertNode(distribution(generator));
+			}
+			avl.freeze();
+			avl.clearDeferred(true).wait(); });
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	std::ofstream out(path);
+	const size_t written = Trace::writeChromeJson(out);
+	if (!out)
+	{
+		std::cout << "Cannot write " << path << "\n";
+		return 1;
+	}
+	std::cout << written << " trace events written to " << path << "\n";
+	return 0;
+}
+
+int benchmarkLatency()
+{
+	// Constants
+	static constexpr int OPERATIONS = 200000;
+	static constexpr int THREAD_COUNT = 4;
+	static constexpr uint64_t PACING_INTERVAL = 2000; // ns between the intended starts of paced operations
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> keyDistribution(0, OPERATIONS * 10);
+	std::vector<int> keys(OPERATIONS);
+	std::vector<std::string> strKeys(OPERATIONS);
+	for (int i = 0; i < OPERATIONS; ++i)
+	{
+		keys[i] = keyDistribution(generator);
+		strKeys[i] = std::to_string(keys[i]);
+	}
+
+	// single threaded per-operation latencies
+	{
+		HashTable<std::string, size_t> ht(OPERATIONS);
+		LatencyHistogram putLatencies;
+		LatencyHistogram getLatencies;
+		for (int i = 0; i < OPERATIONS; ++i)
+		{
+			LatencyTimer timer(putLatencies);
+			ht.put(strKeys[i], i);
+		}
+		for (int i = 0; i < OPERATIONS; ++i)
+		{
+			LatencyTimer timer(getLatencies);
+			ht.get(strKeys[i]);
+		}
+		std::cout << "HashTable::put\n";
+		putLatencies.printPercentiles(std::cout);
+		std::cout << "HashTable::get\n";
+		getLatencies.printPercentiles(std::cout);
+	}
+	{
+		AVLTree<int> t;
+		LatencyHistogram insertLatencies;
+		LatencyHistogram removeLatencies;
+		for (const int key : keys)
+		{
+			LatencyTimer timer(insertLatencies);
+			t.insertNode(key);
+		}
+		for (const int key : keys)
+		{
+			LatencyTimer timer(removeLatencies);
+			t.removeNode(key);
+		}
+		std::cout << "AVLTree::insertNode\n";
+		insertLatencies.printPercentiles(std::cout);
+		std::cout << "AVLTree::removeNode\n";
+		removeLatencies.printPercentiles(std::cout);
+	}
+
+	// every thread records into its own histogram, they are merged afterwards
+	{
+		ConcurrentAVLTree<int> t;
+		std::vector<LatencyHistogram> perThread(THREAD_COUNT);
+		std::vector<std::thread> threads;
+		for (int id = 0; id < THREAD_COUNT; ++id)
+		{
+			threads.emplace_back([&, id]()
+								 {
+				for (int i = id; i < OPERATIONS; i += THREAD_COUNT)
+				{
+					LatencyTimer timer(perThread[id]);
+					t.insertNode(keys[i]);
+				} });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+		LatencyHistogram merged;
+		for (const LatencyHistogram &histogram : perThread)
+		{
+			merged.add(histogram);
+		}
+		std::cout << "ConcurrentAVLTree::insertNode on " << THREAD_COUNT << " threads\n";
+		merged.printPercentiles(std::cout);
+	}
+
+	// paced load: a stall delays every operation that should have started during it, which a plain
+	// measurement of the service time doesn't show (coordinated omission)
+	{
+		AVLTree<int> t;
+		LatencyHistogram rawLatencies;
+		LatencyHistogram correctedLatencies;
+		uint64_t intendedStart = LatencyTimer::now();
+		for (const int key : keys)
+		{
+			while (LatencyTimer::now() < intendedStart)
+			{
+			}
+			const uint64_t begin = LatencyTimer::now();
+			t.insertNode(key);
+			const uint64_t latency = LatencyTimer::now() - begin;
+			rawLatencies.recordValue(latency);
+			correctedLatencies.recordCorrectedValue(latency, PACING_INTERVAL);
+			intendedStart += PACING_INTERVAL;
+			// catch up after a stall instead of running back to back
+			intendedStart = std::max(intendedStart, LatencyTimer::now());
+		}
+		std::cout << "AVLTree::insertNode every " << PACING_INTERVAL << " ns\n";
+		rawLatencies.printPercentiles(std::cout);
+		std::cout << "AVLTree::insertNode every " << PACING_INTERVAL << " ns, corrected for coordinated omission\n";
+		correctedLatencies.printPercentiles(std::cout);
+	}
+
+	return 0;
+}
+
+int benchmarkMemoryUsage()
+{
+	// Constants
+	static const std::vector<int> SIZES = {1000, 100000, 1000000};
+
+	if (!AllocationTracker::isEnabled())
+	{
+		std::cout << "AllocationTracker is compiled out, the live and peak heap need -DENABLE_ALLOCATION_TRACKING=ON\n\n";
+	}
+
+	// what the container reports, and what the whole heap shows while building it, e.g. temporary buffers in the peak
+	const auto measure = [](const char *name, const auto &build)
+	{
+		AllocationTracker::resetPeak();
+		const MemoryUsage before = AllocationTracker::getUsage();
+		const size_t allocationsBefore = AllocationTracker::getTotalAllocations();
+		const MemoryUsage usage = build();
+		const MemoryUsage after = AllocationTracker::getUsage();
+
+		std::cout << name << ": ";
+		usage.print(std::cout);
+		if (AllocationTracker::isEnabled())
+		{
+			std::cout << "\theap: " << AllocationTracker::getTotalAllocations() - allocationsBefore << " allocations, peak "
+					  << after.peakBytes - before.bytesLive << " B while building\n";
+		}
+	};
+
+	for (const int size : SIZES)
+	{
+		std::vector<int> keys(size);
+		std::iota(keys.begin(), keys.end(), 0);
+		std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+		std::cout << size << " int elements\n";
+
+		measure("LinkedList", [&]()
+				{
+			LinkedList<int> ll;
+			for (const int key : keys)
+			{
+				ll.insertAtHead(key);
+			}
+			return ll.memoryUsage(); });
+		measure("HashTable", [&]()
+				{
+			HashTable<int, int> ht(keys.size());
+			for (const int key : keys)
+			{
+				ht.put(key, key);
+			}
+			return ht.memoryUsage(); });
+		measure("BinarySearchTree", [&]()
+				{
+			BinarySearchTree<int> bst;
+			for (const int key : keys)
+			{
+				bst.insertNode(key);
+			}
+			bst.rebalance();
+			return bst.memoryUsage(); });
+		measure("AVLTree", [&]()
+				{
+			AVLTree<int> avl;
+			for (const int key : keys)
+			{
+				avl.insertNode(key);
+			}
+			return avl.memoryUsage(); });
+		measure("AVLTree::insertBatch", [&]()
+				{
+			AVLTree<int> avl;
+			avl.insertBatch(keys);
+			return avl.memoryUsage(); });
+		std::cout << "\n";
+	}
+
+	return 0;
+}
+
+int benchmarkAVLTreeBatchInsertion()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 1000000;
+	static constexpr int BATCHES = 20;
+	static constexpr int BATCH_SIZE = 50000;
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, TREE_SIZE * 4);
+
+	std::vector<int> prefill;
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		prefill.push_back(distribution(generator));
+	}
+	std::vector<std::vector<int>> batches(BATCHES);
+	for (auto &batch : batches)
+	{
+		for (int i = 0; i < BATCH_SIZE; ++i)
+		{
+			batch.push_back(distribution(generator));
+		}
+	}
+
+	AVLTree<int> perKey;
+	AVLTree<int> batched;
+	AVLTree<int> parallelBatched;
+	perKey.insertBatch(prefill);
+	batched.insertBatch(prefill);
+	parallelBatched.insertBatch(prefill);
+
+	std::cout << "AVLTree::insertNode per key ";
+	{
+		Timer timer;
+		for (const auto &batch : batches)
+		{
+			for (const int key : batch)
+			{
+				perKey.insertNode(key);
+			}
+		}
+	}
+	std::cout << "AVLTree::insertBatch ";
+	{
+		Timer timer;
+		for (const auto &batch : batches)
+		{
+			batched.insertBatch(batch);
+		}
+	}
+	std::cout << "AVLTree::insertBatch parallel ";
+	{
+		Timer timer;
+		for (const auto &batch : batches)
+		{
+			parallelBatched.insertBatch(batch, true);
+		}
+	}
+
+	return 0;
+}
+
+int benchmarkAVLTreeFingerSearch()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 2000000;
+
+	// time-series like keys: increasing with a small jitter
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> jitterDistribution(-16, 16);
+	std::vector<int> keys;
+	keys.reserve(TREE_SIZE);
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		keys.push_back(i * 4 + jitterDistribution(generator));
+	}
+
+	AVLTree<int> fromRoot;
+	AVLTree<int> fromHint;
+	std::cout << "AVLTree::insertNode from the root ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			fromRoot.insertNode(key);
+		}
+	}
+	std::cout << "AVLTree::insertNode with hint ";
+	{
+		Timer timer;
+		AVLNode<int> *hint = nullptr;
+		for (const int key : keys)
+		{
+			hint = fromHint.insertNode(hint, key);
+		}
+	}
+
+	size_t foundFromRoot = 0;
+	size_t foundFromFinger = 0;
+	std::cout << "AVLTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundFromRoot += fromRoot.searchNode(key) != nullptr;
+		}
+	}
+	std::cout << "AVLTree::searchFrom ";
+	{
+		Timer timer;
+		AVLNode<int> *finger = fromHint.searchNode(keys.front());
+		for (const int key : keys)
+		{
+			AVLNode<int> *found = fromHint.searchFrom(finger, key);
+			if (found != nullptr)
+			{
+				finger = found;
+				++foundFromFinger;
+			}
+		}
+	}
+
+	// also prevents the compiler from removing the searches
+	return foundFromRoot == foundFromFinger ? 0 : -1;
+}
+
+int benchmarkTreeFile()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 1000000;
+	const std::string path = (std::filesystem::temp_directory_path() / "CDataStructure_tree_file_bench.bin").string();
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, TREE_SIZE * 4);
+	std::vector<int> keys;
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		keys.push_back(distribution(generator));
+	}
+
+	AVLTree<int> t;
+	std::cout << "AVLTree::insertNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			t.insertNode(key);
+		}
+	}
+	std::cout << "AVLTree::serialize ";
+	{
+		Timer timer;
+		std::ofstream out(path, std::ios::binary);
+		t.serialize(out);
+	}
+	AVLTree<int> tLoaded;
+	std::cout << "AVLTree::deserialize ";
+	{
+		Timer timer;
+		std::ifstream in(path, std::ios::binary);
+		tLoaded.deserialize(in);
+	}
+	MappedTree<int> mapped;
+	std::cout << "MappedTree::open ";
+	{
+		Timer timer;
+		mapped.open(path);
+	}
+
+	size_t foundLoaded = 0;
+	size_t foundMapped = 0;
+	std::cout << "AVLTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundLoaded += tLoaded.searchNode(key) != nullptr;
+		}
+	}
+	std::cout << "MappedTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundMapped += mapped.searchNode(key) != nullptr;
+		}
+	}
+
+	mapped.close();
+	std::filesystem::remove(path);
+	// also prevents the compiler from removing the searches
+	return foundLoaded == foundMapped ? 0 : -1;
+}
+
+int benchmarkAVLTreeLazyDeletion()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 1000000;
+	static constexpr int REMOVALS = 600000;
+
+	std::mt19937 generator(42);
+	std::vector<int> keys(TREE_SIZE);
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		keys[i] = i;
+	}
+	AVLTree<int> eager;
+	AVLTree<int> lazy;
+	eager.insertBatch(keys);
+	lazy.insertBatch(keys);
+	std::shuffle(keys.begin(), keys.end(), generator);
+
+	std::cout << "AVLTree::removeNode ";
+	{
+		Timer timer;
+		for (int i = 0; i < REMOVALS; ++i)
+		{
+			eager.removeNode(keys[i]);
+		}
+	}
+	std::cout << "AVLTree::removeNodeLazy ";
+	{
+		Timer timer;
+		for (int i = 0; i < REMOVALS; ++i)
+		{
+			lazy.removeNodeLazy(keys[i]);
+		}
+	}
+
+	return eager.getSize() == lazy.getSize() ? 0 : -1;
+}
+
+// replays operations (key >= 0 searches, key < 0 inserts or removes ~key) and returns the amount of found keys
+template <typename Tree>
+size_t runMixedWorkload(Tree &t, const std::vector<int> &operations)
+{
+	size_t found = 0;
+	bool insert = true;
+	for (const int operation : operations)
+	{
+		if (operation >= 0)
+		{
+			found += t.searchNode(operation) != nullptr;
+		}
+		else
+		{
+			if (insert)
+				t.insertNode(~operation);
+			else
+				t.removeNode(~operation);
+			insert = !insert;
+		}
+	}
+	return found;
+}
+
+int benchmarkRedBlackTree()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 500000;
+	static constexpr int OPERATIONS = 2000000;
+	static constexpr int READ_PERCENTAGES[] = {0, 50, 90, 99};
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> keyDistribution(0, 2 * TREE_SIZE);
+	std::uniform_int_distribution<int> percentDistribution(0, 99);
+	std::vector<int> keys(TREE_SIZE);
+	for (int &key : keys)
+	{
+		key = keyDistribution(generator);
+	}
+
+	int result = 0;
+	for (const int readPercentage : READ_PERCENTAGES)
+	{
+		std::vector<int> operations(OPERATIONS);
+		for (int &operation : operations)
+		{
+			const int key = keyDistribution(generator);
+			operation = percentDistribution(generator) < readPercentage ? key : ~key;
+		}
+
+		AVLTree<int> avl;
+		RedBlackTree<int> rbt;
+		for (const int key : keys)
+		{
+			avl.insertNode(key);
+			rbt.insertNode(key);
+		}
+
+		size_t foundAvl = 0;
+		size_t foundRbt = 0;
+		std::cout << readPercentage << "% reads\n";
+		std::cout << "AVLTree ";
+		{
+			Timer timer;
+			foundAvl = runMixedWorkload(avl, operations);
+		}
+		std::cout << "RedBlackTree ";
+		{
+			Timer timer;
+			foundRbt = runMixedWorkload(rbt, operations);
+		}
+		// both trees see the same operations, so they have to agree
+		if (foundAvl != foundRbt || avl.getSize() != rbt.getSize())
+			result = -1;
+	}
+	return result;
+}
+
+int benchmarkBinarySearchTreeRebalancing()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 20000;
+	static constexpr int SEARCHES = 1000000;
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, TREE_SIZE - 1);
+	std::vector<int> searches(SEARCHES);
+	for (int &key : searches)
+	{
+		key = distribution(generator);
+	}
+
+	// sorted ingestion, the plain tree becomes a list and every insertion walks all of it
+	BinarySearchTree<int> plain;
+	BinarySearchTree<int> rebalanced;
+	BinarySearchTree<int> scapegoat;
+	scapegoat.setScapegoatMode(true);
+	std::cout << "BinarySearchTree sorted insertion ";
+	{
+		Timer timer;
+		for (int i = 0; i < TREE_SIZE; ++i)
+		{
+			plain.insertNode(i);
+		}
+	}
+	std::cout << "BinarySearchTree sorted insertion + rebalance ";
+	{
+		Timer timer;
+		for (int i = 0; i < TREE_SIZE; ++i)
+		{
+			rebalanced.insertNode(i);
+		}
+		rebalanced.rebalance();
+	}
+	std::cout << "BinarySearchTree sorted insertion in scapegoat mode ";
+	{
+		Timer timer;
+		for (int i = 0; i < TREE_SIZE; ++i)
+		{
+			scapegoat.insertNode(i);
+		}
+	}
+
+	size_t found = 0;
+	std::cout << "BinarySearchTree::find unbalanced ";
+	{
+		Timer timer;
+		for (int i = 0; i < SEARCHES / 100; ++i)
+		{
+			found += plain.find(searches[i]) != nullptr;
+		}
+	}
+	std::cout << "BinarySearchTree::find rebalanced ";
+	{
+		Timer timer;
+		for (const int key : searches)
+		{
+			found += rebalanced.find(key) != nullptr;
+		}
+	}
+	std::cout << "BinarySearchTree::find scapegoat mode ";
+	{
+		Timer timer;
+		for (const int key : searches)
+		{
+			found += scapegoat.find(key) != nullptr;
+		}
+	}
+	std::cout << "(the unbalanced tree only searched " << SEARCHES / 100 << " keys)\n";
+
+	return found == SEARCHES * 2 + SEARCHES / 100 ? 0 : -1;
+}
+
+int benchmarkSplayTree()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 1000000;
+	static constexpr int SEARCHES = 5000000;
+	static constexpr double ZIPF_EXPONENT = 1.3;
+
+	std::mt19937 generator(42);
+	std::vector<int> keys(TREE_SIZE);
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		keys[i] = i;
+	}
+	std::shuffle(keys.begin(), keys.end(), generator);
+
+	BinarySearchTree<int> bst;
+	SplayTree<int> splay;
+	for (const int key : keys)
+	{
+		bst.insertNode(key);
+		splay.insertNode(key);
+	}
+
+	// the key of rank r is searched with a probability proportional to 1 / r^ZIPF_EXPONENT
+	std::vector<double> cumulativeWeights(TREE_SIZE);
+	double totalWeight = 0;
+	for (int rank = 0; rank < TREE_SIZE; ++rank)
+	{
+		totalWeight += 1.0 / std::pow(rank + 1, ZIPF_EXPONENT);
+		cumulativeWeights[rank] = totalWeight;
+	}
+	std::uniform_real_distribution<double> weightDistribution(0, totalWeight);
+	std::vector<int> searches;
+	searches.reserve(SEARCHES);
+	for (int i = 0; i < SEARCHES; ++i)
+	{
+		const auto rank = std::lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), weightDistribution(generator)) - cumulativeWeights.begin();
+		searches.push_back(keys[std::min<size_t>(rank, TREE_SIZE - 1)]);
+	}
+
+	size_t foundBst = 0;
+	size_t foundSplay = 0;
+	std::cout << "BinarySearchTree::find ";
+	{
+		Timer timer;
+		for (const int key : searches)
+		{
+			foundBst += bst.find(key) != nullptr;
+		}
+	}
+	std::cout << "SplayTree::find ";
+	{
+		Timer timer;
+		for (const int key : searches)
+		{
+			foundSplay += splay.find(key) != nullptr;
+		}
+	}
+
+	// also prevents the compiler from removing the searches
+	return foundBst == foundSplay ? 0 : -1;
+}
+
+int benchmarkFrozenAVLTree()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 1000000;
+	static constexpr int SEARCHES = 10000000;
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, TREE_SIZE * 4);
+
+	AVLTree<int> t;
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		t.insertNode(distribution(generator));
+	}
+	const auto frozen = t.freeze();
+
+	std::vector<int> keys;
+	keys.reserve(SEARCHES);
+	for (int i = 0; i < SEARCHES; ++i)
+	{
+		keys.push_back(distribution(generator));
+	}
+
+	size_t foundTree = 0;
+	size_t foundFrozen = 0;
+	std::cout << "AVLTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundTree += t.searchNode(key) != nullptr;
+		}
+	}
+	std::cout << "FrozenAVLTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundFrozen += frozen.searchNode(key) != nullptr;
+		}
+	}
+
+	// also prevents the compiler from removing the searches
+	return foundTree == foundFrozen ? 0 : -1;
+}
+
+int benchmarkBPlusTree()
+{
+	// Constants
+	static constexpr int TREE_SIZE = 1000000;
+	static constexpr int SEARCHES = 10000000;
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, TREE_SIZE * 4);
+
+	AVLTree<int> avl;
+	BPlusTree<int, int> bpt;
+	for (int i = 0; i < TREE_SIZE; ++i)
+	{
+		const int key = distribution(generator);
+		avl.insertNode(key);
+		bpt.insertNode(key, i);
+	}
+
+	std::vector<int> keys;
+	keys.reserve(SEARCHES);
+	for (int i = 0; i < SEARCHES; ++i)
+	{
+		keys.push_back(distribution(generator));
+	}
+
+	size_t foundAVL = 0;
+	size_t foundBPlus = 0;
+	std::cout << "AVLTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundAVL += avl.searchNode(key) != nullptr;
+		}
+	}
+	std::cout << "BPlusTree::searchNode ";
+	{
+		Timer timer;
+		for (const int key : keys)
+		{
+			foundBPlus += bpt.searchNode(key) != nullptr;
+		}
+	}
+
+	// also prevents the compiler from removing the searches
+	return foundAVL == foundBPlus ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+	// benchmarks are selected by name on the command line since they take a while to run
+	if (argc > 1 && std::string(argv[1]) == "bench-concurrent-bst")
+	{
+		return benchmarkConcurrentBST();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-concurrent-avl")
+	{
+		return benchmarkConcurrentAVLTree();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-parallel-avl")
+	{
+		return benchmarkAVLTreeParallelReduce();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-teardown")
+	{
+		return benchmarkDeferredTeardown();
+	}
+	if (argc > 2 && std::string(argv[1]) == "trace")
+	{
+		return traceDataStructures(argv[2]);
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-latency")
+	{
+		return benchmarkLatency();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-memory")
+	{
+		return benchmarkMemoryUsage();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-batch-avl")
+	{
+		return benchmarkAVLTreeBatchInsertion();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-finger-avl")
+	{
+		return benchmarkAVLTreeFingerSearch();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-tree-file")
+	{
+		return benchmarkTreeFile();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-lazy-avl")
+	{
+		return benchmarkAVLTreeLazyDeletion();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-red-black")
+	{
+		return benchmarkRedBlackTree();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-bst-rebalance")
+	{
+		return benchmarkBinarySearchTreeRebalancing();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-splay")
+	{
+		return benchmarkSplayTree();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-frozen-avl")
+	{
+		return benchmarkFrozenAVLTree();
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench-bplus-tree")
+	{
+		return benchmarkBPlusTree();
+	}
+
 	// return testingHashTableWithBenchmark();
 	// return testingBinarySearchTree();
 	testAVLTreeDeletionCases();
 	testAVLTreeInsertionCases();
+	testAVLTreeBatchInsertion();
+	testAVLTreeFingerSearch();
+	testAVLTreeLazyDeletion();
+#if defined(AVL_TREE_STATS)
+	testAVLTreeStats();
+#endif
+	testConcurrentAVLTree();
+	testConcurrentBST();
+	testPersistentAVLTreeSnapshots();
+	testAVLMap();
+	testCompactAVLTree();
+	testFrozenAVLTree();
+	testIntervalTree();
+	testTreeFile();
+	testBinarySearchTreeRebalancing();
+	testTreeTraversals();
+	testAVLTreeParallelTraversal();
+	testDeferredTeardown();
+	testTrace();
+	testLatencyHistogram();
+	testMemoryUsage();
+	testSplayTree();
+	testTreap();
+	testRedBlackTree();
+	testBPlusTree();
 	return testAVLTreeSearchCases();
 }
\ No newline at end of file